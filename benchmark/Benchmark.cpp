@@ -0,0 +1,174 @@
+#include "Benchmark.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+namespace {
+
+// only run benchmarks whose name contains this
+std::string_view filter;
+
+volatile size_t sink = 0;
+
+}  // namespace
+
+namespace SimpleJson::Benchmark {
+
+void run(std::string_view name, size_t bytes,
+         const std::function<void()>& fn) {
+    if (name.find(filter) == std::string_view::npos) {
+        return;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    constexpr auto minDuration = std::chrono::milliseconds(500);
+
+    // warm up caches and branch predictors
+    fn();
+
+    size_t iterations = 0;
+    const auto start = Clock::now();
+    auto elapsed = Clock::duration::zero();
+    do {
+        fn();
+        ++iterations;
+        elapsed = Clock::now() - start;
+    } while (elapsed < minDuration);
+
+    const auto seconds = std::chrono::duration<double>(elapsed).count();
+    const auto nanosPerOp = seconds * 1e9 / static_cast<double>(iterations);
+    const auto megabytesPerSec =
+        static_cast<double>(bytes * iterations) / seconds / 1e6;
+    std::printf("%-48.*s %12.0f ns/op %10.1f MB/s\n",
+                static_cast<int>(name.size()), name.data(), nanosPerOp,
+                megabytesPerSec);
+}
+
+void keep(const size_t value) {
+    sink = value;
+}
+
+std::string makeRecords(const size_t count, const int indent) {
+    std::string doc;
+    int level = 0;
+    // start a new line for an element or member
+    const auto newLine = [&]() {
+        if (indent > 0) {
+            doc.push_back('\n');
+            doc.append(static_cast<size_t>(level * indent), ' ');
+        }
+    };
+    const auto key = [&](const std::string_view name) {
+        newLine();
+        doc.push_back('"');
+        doc += name;
+        doc += indent > 0 ? "\": " : "\":";
+    };
+
+    doc.push_back('[');
+    ++level;
+    for (size_t i = 0; i < count; ++i) {
+        newLine();
+        doc.push_back('{');
+        ++level;
+        key("id");
+        doc += std::to_string(i * 7919) + ",";
+        key("name");
+        doc += "\"user_" + std::to_string(i) + "\",";
+        key("active");
+        doc += i % 3 == 0 ? "false," : "true,";
+        key("score");
+        doc += std::to_string(static_cast<double>(i) * 0.125) + ",";
+        key("tags");
+        doc += "[\"alpha\", \"beta\"],";
+        key("address");
+        doc.push_back('{');
+        ++level;
+        key("city");
+        doc += "\"Springfield\",";
+        key("zip");
+        doc += "\"" + std::to_string(10000 + i) + "\"";
+        --level;
+        newLine();
+        doc.push_back('}');
+        --level;
+        newLine();
+        doc += i + 1 < count ? "}," : "}";
+    }
+    --level;
+    newLine();
+    doc.push_back(']');
+    return doc;
+}
+
+std::string makeMessages(const size_t count, const size_t length) {
+    std::string message;
+    for (size_t i = 0; message.size() < length; ++i) {
+        message += i % 64 == 63 ? "\\n" : "lorem ipsum ";
+    }
+
+    std::string doc = "[";
+    for (size_t i = 0; i < count; ++i) {
+        doc += i == 0 ? "\"" : ",\"";
+        doc += message;
+        doc += "\"";
+    }
+    doc += "]";
+    return doc;
+}
+
+std::string makeIntegers(const size_t count) {
+    // a fixed linear congruential sequence, so runs are comparable
+    uint64_t state = 1;
+    std::string doc = "[";
+    for (size_t i = 0; i < count; ++i) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        // mostly small counters, some timestamps and large ids
+        const auto width = (state >> 60U) % 4;
+        const auto number = static_cast<long long>(
+            (state >> 4U) % (width == 0   ? 100
+                             : width == 1 ? 100'000
+                             : width == 2 ? 10'000'000'000'000
+                                          : 1'000'000'000'000'000'000));
+        if (i != 0) {
+            doc.push_back(',');
+        }
+        doc += std::to_string(i % 5 == 0 ? -number : number);
+    }
+    doc.push_back(']');
+    return doc;
+}
+
+std::string makeReals(const size_t count) {
+    // a fixed linear congruential sequence, so runs are comparable
+    uint64_t state = 1;
+    std::string doc = "[";
+    std::array<char, 32> buf{};
+    for (size_t i = 0; i < count; ++i) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        // coordinates and measurements, printed in full precision
+        const auto number = static_cast<double>(state >> 11U) * 0x1p-53 *
+                            (i % 2 == 0 ? 360.0 : 1e6) * (i % 3 == 0 ? -1 : 1);
+        if (i != 0) {
+            doc.push_back(',');
+        }
+        std::snprintf(buf.data(), buf.size(), "%.17g", number);
+        doc += buf.data();
+    }
+    doc.push_back(']');
+    return doc;
+}
+
+}  // namespace SimpleJson::Benchmark
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        filter = argv[1];
+    }
+
+    SimpleJson::Benchmark::runReaderBenchmarks();
+    SimpleJson::Benchmark::runWriterBenchmarks();
+    return 0;
+}
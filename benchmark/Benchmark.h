@@ -0,0 +1,37 @@
+#ifndef SIMPLEJSON_BENCHMARK_H
+#define SIMPLEJSON_BENCHMARK_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace SimpleJson::Benchmark {
+
+/// run `fn` repeatedly for a while, print its throughput over `bytes`
+/// @note skipped if the name does not contain the command line filter
+void run(std::string_view name, size_t bytes, const std::function<void()>& fn);
+
+/// keep the computation of `value` from being optimized away
+void keep(size_t value);
+
+/// a document of `count` records, `indent` spaces per level or minified if 0
+std::string makeRecords(size_t count, int indent);
+
+/// an array of `count` log-like strings of about `length` chars, mostly
+/// plain text with an occasional escape
+std::string makeMessages(size_t count, size_t length);
+
+/// an array of `count` integers of mixed widths, like a metrics series
+std::string makeIntegers(size_t count);
+
+/// an array of `count` reals printed in full precision
+std::string makeReals(size_t count);
+
+// suites, one per component
+void runReaderBenchmarks();
+void runWriterBenchmarks();
+
+}  // namespace SimpleJson::Benchmark
+
+#endif  // SIMPLEJSON_BENCHMARK_H
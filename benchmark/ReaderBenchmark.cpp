@@ -0,0 +1,448 @@
+#include <cstdint>
+#include <cstdlib>
+#include <memory_resource>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Number.h"
+#include "Simd.h"
+#include "simplejson/KeyTable.h"
+#include "simplejson/Lazy.h"
+#include "simplejson/PushParser.h"
+#include "simplejson/Reader.h"
+#include "simplejson/Stream.h"
+#include "simplejson/Tape.h"
+#include "simplejson/Writer.h"
+
+namespace SimpleJson::Benchmark {
+
+namespace {
+
+constexpr size_t RECORD_COUNT = 10'000;
+constexpr size_t MESSAGE_COUNT = 1'000;
+constexpr size_t MESSAGE_LENGTH = 2'000;
+constexpr size_t INTEGER_COUNT = 100'000;
+constexpr size_t REAL_COUNT = 100'000;
+// chunks fed to PushParser, as read from a socket or file
+constexpr size_t CHUNK_SIZE = 64 * 1024;
+// nested documents of a deep tree
+constexpr size_t NESTED_COUNT = 1'000;
+constexpr size_t NESTED_DEPTH = 500;
+// records of an envelope of about 200 KB
+constexpr size_t ENVELOPE_RECORD_COUNT = 1'300;
+
+// records followed by a few fields of metadata
+std::string makeEnvelope() {
+    return R"({"records":)" + makeRecords(ENVELOPE_RECORD_COUNT, 0) +
+           R"(,"meta":{"version":3,"source":"benchmark","count":1300}})";
+}
+
+// an array of `count` trees nested `depth` deep, arrays and objects in turn
+std::string makeNested(const size_t count, const size_t depth) {
+    std::string doc = "[";
+    for (size_t i = 0; i < count; ++i) {
+        if (i != 0) {
+            doc += ',';
+        }
+        for (size_t level = 0; level < depth; ++level) {
+            doc += level % 2 == 0 ? "[1," : R"({"k":)";
+        }
+        doc += "null";
+        for (size_t level = depth; level > 0; --level) {
+            doc += level % 2 == 1 ? ']' : '}';
+        }
+    }
+    return doc + "]";
+}
+
+// the records of `doc`, one per line as in a log of events
+std::string makeLines(const std::string& doc) {
+    Reader reader;
+    Value records;
+    reader.parse(doc, records);
+    Writer writer;
+    std::string lines;
+    for (size_t i = 0; i < records.size(); ++i) {
+        writer.write(records[i], lines);
+        lines += '\n';
+    }
+    return lines;
+}
+
+// skip every whitespace run in `doc` the way Reader::skipWhitespace does,
+// handing runs longer than one char to `kernel`
+void benchSkipWhitespace(const std::string_view name, const std::string& doc,
+                         const char* (*kernel)(const char*)) {
+    run(name, doc.size(), [&]() {
+        size_t tokens = 0;
+        auto p = doc.c_str();
+        while (*p != 0) {
+            if (Simd::isWhitespace(*p)) {
+                ++p;
+                if (Simd::isWhitespace(*p)) {
+                    p = kernel(p);
+                }
+            }
+            if (*p != 0) {
+                ++p;
+                ++tokens;
+            }
+        }
+        keep(tokens);
+    });
+}
+
+// find the structural chars of `doc` with `kernel`
+void benchIndexStructurals(const std::string_view name, const std::string& doc,
+                           bool (*kernel)(const char*, size_t, uint32_t*,
+                                          size_t&)) {
+    std::vector<uint32_t> positions(doc.size());
+    run(name, doc.size(), [&]() {
+        size_t count = 0;
+        (void)kernel(doc.data(), doc.size(), positions.data(), count);
+        keep(count);
+    });
+}
+
+void benchParse(const std::string_view name, const std::string& doc) {
+    Reader reader;
+    Value value;
+    run(name, doc.size(), [&]() {
+        reader.parse(doc, value);
+        keep(value.size());
+    });
+}
+
+// parse a view, which is not terminated
+void benchParseView(const std::string_view name, const std::string& doc) {
+    Reader reader;
+    Value value;
+    run(name, doc.size(), [&]() {
+        reader.parse(std::string_view(doc), value);
+        keep(value.size());
+    });
+}
+
+// parse into an arena, dropping the whole tree at once
+void benchParseArena(const std::string_view name, const std::string& doc) {
+    std::pmr::monotonic_buffer_resource arena;
+    Reader reader(&arena);
+    run(name, doc.size(), [&]() {
+        {
+            Value value;
+            reader.parse(doc, value);
+            keep(value.size());
+        }
+        arena.release();
+    });
+}
+
+void benchParseIndexed(const std::string_view name, const std::string& doc) {
+    Reader reader;
+    Value value;
+    run(name, doc.size(), [&]() {
+        reader.parseIndexed(doc, value);
+        keep(value.size());
+    });
+}
+
+// parse in two stages into an arena, dropping the whole tree at once
+void benchParseIndexedArena(const std::string_view name,
+                            const std::string& doc) {
+    std::pmr::monotonic_buffer_resource arena;
+    Reader reader(&arena);
+    run(name, doc.size(), [&]() {
+        {
+            Value value;
+            reader.parseIndexed(doc, value);
+            keep(value.size());
+        }
+        arena.release();
+    });
+}
+
+// parse on `threadCount` threads, the elements of the root in batches
+void benchParseParallel(const std::string_view name, const std::string& doc,
+                        const unsigned threadCount) {
+    Reader reader;
+    Value value;
+    run(name, doc.size(), [&]() {
+        reader.parseParallel(doc, value, threadCount);
+        keep(value.size());
+    });
+}
+
+// parse a fresh copy in situ, strings refer to the copy
+void benchParseInsitu(const std::string_view name, const std::string& doc) {
+    Reader reader;
+    Value value;
+    std::string copy;
+    run(name, doc.size(), [&]() {
+        copy = doc;
+        reader.parseInsitu(copy, value);
+        keep(value.size());
+    });
+}
+
+// convert each number of an array of reals with `convert`
+void benchConvertReals(const std::string_view name, const std::string& doc,
+                       double (*convert)(const char*)) {
+    run(name, doc.size(), [&]() {
+        double sum = 0;
+        for (auto p = doc.data() + 1; *p != 0; ++p) {
+            sum += convert(p);
+            while (*p != ',' && *p != 0) {
+                ++p;
+            }
+        }
+        keep(static_cast<size_t>(sum));
+    });
+}
+
+// parse with keys interned in a table shared by all iterations
+void benchParseInterned(const std::string_view name, const std::string& doc) {
+    KeyTable keyTable;
+    Reader reader(std::pmr::get_default_resource(), &keyTable);
+    Value value;
+    run(name, doc.size(), [&]() {
+        reader.parse(doc, value);
+        keep(value.size());
+    });
+}
+
+// parse into events only, aggregating numbers without building a tree
+void benchParseEvents(const std::string_view name, const std::string& doc) {
+    struct Handler : BaseHandler {
+        void onInteger(const Integer val) { sum += static_cast<size_t>(val); }
+        void onReal(const Real val) { sum += static_cast<size_t>(val); }
+        size_t sum = 0;
+    };
+    Reader reader;
+    run(name, doc.size(), [&]() {
+        Handler handler;
+        reader.parse(doc, handler);
+        keep(handler.sum);
+    });
+}
+
+// parse `doc` delivered in chunks of `chunkSize` chars
+void benchPushParse(const std::string_view name, const std::string& doc,
+                    const size_t chunkSize) {
+    Value value;
+    PushParser parser(value);
+    run(name, doc.size(), [&]() {
+        const std::string_view document(doc);
+        for (size_t pos = 0; pos < document.size(); pos += chunkSize) {
+            parser.feed(document.substr(pos, chunkSize));
+        }
+        parser.finish();
+        keep(value.size());
+    });
+}
+
+// read the values of a stream one at a time
+void benchStreamNext(const std::string_view name, const std::string& doc) {
+    run(name, doc.size(), [&]() {
+        DocumentStream stream(doc);
+        size_t count = 0;
+        for (Value value; stream.next(value);) {
+            ++count;
+        }
+        keep(count);
+    });
+}
+
+// parse the values of a stream in batches on `threadCount` workers
+void benchStreamParseAll(const std::string_view name, const std::string& doc,
+                         const unsigned threadCount) {
+    run(name, doc.size(), [&]() {
+        DocumentStream stream(doc);
+        std::vector<Value> values;
+        stream.parseAll(values, threadCount);
+        keep(values.size());
+    });
+}
+
+void benchParseTape(const std::string_view name, const std::string& doc) {
+    TapeDocument tape;
+    run(name, doc.size(), [&]() {
+        tape.parse(doc);
+        keep(tape.root().size());
+    });
+}
+
+// read a few fields of every record of a parsed tree
+void benchTraverse(const std::string_view name, const std::string& doc) {
+    Reader reader;
+    Value value;
+    reader.parse(doc, value);
+    const auto& records = value;
+    run(name, doc.size(), [&]() {
+        size_t sum = 0;
+        for (size_t i = 0; i < records.size(); ++i) {
+            const auto& record = records[i];
+            sum += static_cast<size_t>(record["id"].asInteger()) +
+                   record["name"].asStringView().size() +
+                   static_cast<size_t>(record["score"].asReal()) +
+                   record["tags"].size() +
+                   record["address"]["zip"].asStringView().size();
+        }
+        keep(sum);
+    });
+}
+
+// read the same fields of every record of a parsed tape
+void benchTraverseTape(const std::string_view name, const std::string& doc) {
+    TapeDocument tape;
+    tape.parse(doc);
+    run(name, doc.size(), [&]() {
+        size_t sum = 0;
+        for (const auto record : tape.root()) {
+            sum += static_cast<size_t>(record["id"].asInteger()) +
+                   record["name"].asStringView().size() +
+                   static_cast<size_t>(record["score"].asReal()) +
+                   record["tags"].size() +
+                   record["address"]["zip"].asStringView().size();
+        }
+        keep(sum);
+    });
+}
+
+// read three fields of the envelope after parsing all of it
+void benchReadFields(const std::string_view name, const std::string& doc) {
+    Reader reader;
+    Value value;
+    run(name, doc.size(), [&]() {
+        reader.parse(doc, value);
+        const auto& meta = value["meta"];
+        keep(static_cast<size_t>(meta["version"].asInteger()) +
+             meta["source"].asString().size() +
+             value["records"][1000]["name"].asString().size());
+    });
+}
+
+// read three fields of the envelope on demand
+// the same fields, with only their paths parsed
+void benchReadFieldsProjected(const std::string_view name,
+                              const std::string& doc) {
+    Reader reader;
+    Value value;
+    run(name, doc.size(), [&]() {
+        reader.parseProjected(
+            doc, {"/meta/version", "/meta/source", "/records/1000/name"},
+            value);
+        const auto& meta = value["meta"];
+        keep(static_cast<size_t>(meta["version"].asInteger()) +
+             meta["source"].asString().size() +
+             value["records"][1000]["name"].asString().size());
+    });
+}
+
+void benchReadFieldsLazy(const std::string_view name, const std::string& doc) {
+    run(name, doc.size(), [&]() {
+        LazyDocument lazy(doc);
+        const auto meta = lazy["meta"];
+        keep(static_cast<size_t>(meta["version"].asInteger()) +
+             meta["source"].asString().size() +
+             lazy["records"][1000]["name"].asString().size());
+    });
+}
+
+}  // namespace
+
+void runReaderBenchmarks() {
+    const auto minified = makeRecords(RECORD_COUNT, 0);
+    const auto pretty = makeRecords(RECORD_COUNT, 4);
+
+    benchSkipWhitespace("skipWhitespace/scalar/minified", minified,
+                        Simd::skipWhitespaceScalar);
+    benchSkipWhitespace("skipWhitespace/scalar/pretty", pretty,
+                        Simd::skipWhitespaceScalar);
+    if (Simd::hasSse2()) {
+        benchSkipWhitespace("skipWhitespace/sse2/minified", minified,
+                            Simd::skipWhitespaceSse2);
+        benchSkipWhitespace("skipWhitespace/sse2/pretty", pretty,
+                            Simd::skipWhitespaceSse2);
+    }
+    if (Simd::hasAvx2()) {
+        benchSkipWhitespace("skipWhitespace/avx2/minified", minified,
+                            Simd::skipWhitespaceAvx2);
+        benchSkipWhitespace("skipWhitespace/avx2/pretty", pretty,
+                            Simd::skipWhitespaceAvx2);
+    }
+
+    benchIndexStructurals("indexStructurals/scalar/minified", minified,
+                          Simd::indexStructuralsScalar);
+    benchIndexStructurals("indexStructurals/scalar/pretty", pretty,
+                          Simd::indexStructuralsScalar);
+    if (Simd::hasSse2()) {
+        benchIndexStructurals("indexStructurals/sse2/minified", minified,
+                              Simd::indexStructuralsSse2);
+        benchIndexStructurals("indexStructurals/sse2/pretty", pretty,
+                              Simd::indexStructuralsSse2);
+    }
+    if (Simd::hasAvx2()) {
+        benchIndexStructurals("indexStructurals/avx2/minified", minified,
+                              Simd::indexStructuralsAvx2);
+        benchIndexStructurals("indexStructurals/avx2/pretty", pretty,
+                              Simd::indexStructuralsAvx2);
+    }
+
+    benchParse("Reader::parse/minified", minified);
+    benchParse("Reader::parse/pretty", pretty);
+    benchParseView("Reader::parse/minified/view", minified);
+    benchParseIndexed("Reader::parseIndexed/minified", minified);
+    benchParseIndexed("Reader::parseIndexed/pretty", pretty);
+    benchParseParallel("Reader::parseParallel/minified/2", minified, 2);
+    benchParseParallel("Reader::parseParallel/minified/4", minified, 4);
+    const auto messages = makeMessages(MESSAGE_COUNT, MESSAGE_LENGTH);
+    benchParse("Reader::parse/messages", messages);
+    benchParseInsitu("Reader::parseInsitu/messages", messages);
+    benchParseInsitu("Reader::parseInsitu/minified", minified);
+    benchParseArena("Reader::parse/minified/arena", minified);
+    benchParseArena("Reader::parse/pretty/arena", pretty);
+    benchParseIndexedArena("Reader::parseIndexed/minified/arena", minified);
+    benchParseIndexedArena("Reader::parseIndexed/pretty/arena", pretty);
+    benchParseInterned("Reader::parse/minified/interned", minified);
+    benchParseEvents("Reader::parse/minified/events", minified);
+    benchPushParse("PushParser/minified/64k", minified, CHUNK_SIZE);
+    benchPushParse("PushParser/pretty/64k", pretty, CHUNK_SIZE);
+    benchPushParse("PushParser/minified/4k", minified, 4 * 1024);
+    const auto lines = makeLines(minified);
+    benchStreamNext("DocumentStream::next/lines", lines);
+    benchStreamParseAll("DocumentStream::parseAll/lines/1", lines, 1);
+    benchStreamParseAll("DocumentStream::parseAll/lines/4", lines, 4);
+    benchParseTape("TapeDocument::parse/minified", minified);
+    benchParseTape("TapeDocument::parse/pretty", pretty);
+    benchTraverse("Value/records/traverse", minified);
+    benchTraverseTape("TapeDocument/records/traverse", minified);
+    const auto envelope = makeEnvelope();
+    benchReadFields("Reader::parse/envelope/fields", envelope);
+    benchReadFieldsLazy("LazyDocument/envelope/fields", envelope);
+    benchReadFieldsProjected("Reader::parseProjected/envelope/fields",
+                             envelope);
+    const auto nested = makeNested(NESTED_COUNT, NESTED_DEPTH);
+    benchParse("Reader::parse/nested", nested);
+    benchParseEvents("Reader::parse/nested/events", nested);
+    const auto integers = makeIntegers(INTEGER_COUNT);
+    benchParse("Reader::parse/integers", integers);
+    const auto reals = makeReals(REAL_COUNT);
+    benchParse("Reader::parse/reals", reals);
+    benchConvertReals("strtod/reals", reals,
+                      [](const char* str) { return std::strtod(str, nullptr); });
+    benchConvertReals("Number::toReal/reals", reals, [](const char* str) {
+        const auto number = Number::scan(str);
+        Real value = 0;
+        (void)Number::toReal(str, number, value);
+        return value;
+    });
+    benchConvertReals("Number::toRealDecimal/reals", reals,
+                      [](const char* str) {
+                          const auto number = Number::scan(str);
+                          Real value = 0;
+                          (void)Number::toRealDecimal(str, number, value);
+                          return value;
+                      });
+}
+
+}  // namespace SimpleJson::Benchmark
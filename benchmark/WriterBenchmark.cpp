@@ -0,0 +1,78 @@
+#include "Benchmark.h"
+#include "simplejson/Reader.h"
+#include "simplejson/Writer.h"
+
+namespace SimpleJson::Benchmark {
+
+namespace {
+
+constexpr size_t RECORD_COUNT = 10'000;
+constexpr size_t MESSAGE_COUNT = 1'000;
+constexpr size_t MESSAGE_LENGTH = 2'000;
+constexpr size_t INTEGER_COUNT = 100'000;
+constexpr size_t REAL_COUNT = 100'000;
+
+// write the tree parsed from `doc`, throughput is over the written bytes
+void benchWrite(const std::string_view name, const std::string& doc) {
+    Reader reader;
+    Value value;
+    reader.parse(doc, value);
+    Writer writer;
+    const auto bytes = writer.write(value).size();
+    run(name, bytes, [&]() { keep(writer.write(value).size()); });
+}
+
+// append to a document cleared for each iteration, reusing its capacity
+void benchWriteAppend(const std::string_view name, const std::string& doc) {
+    Reader reader;
+    Value value;
+    reader.parse(doc, value);
+    Writer writer;
+    std::string document;
+    writer.write(value, document);
+    run(name, document.size(), [&]() {
+        document.clear();
+        writer.write(value, document);
+        keep(document.size());
+    });
+}
+
+// write in chunks to a sink that only counts them
+void benchWriteSink(const std::string_view name, const std::string& doc) {
+    Reader reader;
+    Value value;
+    reader.parse(doc, value);
+    Writer writer;
+    const auto bytes = writer.write(value).size();
+    const Writer::Sink sink = [](const std::string_view chunk) {
+        keep(chunk.size());
+    };
+    run(name, bytes, [&]() { writer.write(value, sink); });
+}
+
+// write the tree parsed from `doc` on `threadCount` threads
+void benchWriteParallel(const std::string_view name, const std::string& doc,
+                        const unsigned threadCount) {
+    Reader reader;
+    Value value;
+    reader.parse(doc, value);
+    Writer writer(threadCount);
+    const auto bytes = writer.write(value).size();
+    run(name, bytes, [&]() { keep(writer.write(value).size()); });
+}
+
+}  // namespace
+
+void runWriterBenchmarks() {
+    const auto minified = makeRecords(RECORD_COUNT, 0);
+    benchWrite("Writer::write/minified", minified);
+    benchWriteAppend("Writer::write/minified/append", minified);
+    benchWriteSink("Writer::write/minified/sink", minified);
+    benchWriteParallel("Writer::write/minified/parallel/4", minified, 4);
+    benchWrite("Writer::write/messages",
+               makeMessages(MESSAGE_COUNT, MESSAGE_LENGTH));
+    benchWrite("Writer::write/integers", makeIntegers(INTEGER_COUNT));
+    benchWrite("Writer::write/reals", makeReals(REAL_COUNT));
+}
+
+}  // namespace SimpleJson::Benchmark
@@ -0,0 +1,47 @@
+#ifndef SIMPLEJSON_KEYTABLE_H
+#define SIMPLEJSON_KEYTABLE_H
+
+#include <memory_resource>
+#include <string_view>
+#include <unordered_set>
+
+#include "Value.h"
+
+namespace SimpleJson {
+
+/// Interns object keys: a Reader given a table stores each distinct key once
+/// in it, and objects refer to that copy. This only saves memory: lookups
+/// still compare chars unless they pass the interned copy itself.
+/// One table may be shared by many documents of the same shape.
+/// @note values holding interned keys must not outlive the table
+class KeyTable {
+public:
+    KeyTable() : KeyTable(std::pmr::get_default_resource()) {}
+    explicit KeyTable(Value::MemoryResource* resource)
+        : _chars(resource), _keys(resource) {}
+    KeyTable(const KeyTable&) = delete;
+    KeyTable& operator=(const KeyTable&) = delete;
+
+    /// the interned copy of `key`, followed by a NUL
+    [[nodiscard]] std::string_view intern(std::string_view key);
+
+    /// number of distinct keys
+    [[nodiscard]] size_t size() const { return _keys.size(); }
+    /// number of keys interned, and how many of them were already there
+    [[nodiscard]] size_t lookups() const { return _lookups; }
+    [[nodiscard]] size_t hits() const { return _hits; }
+    [[nodiscard]] double hitRate() const;
+
+private:
+    // Chars of the keys, freed all at once with the table
+    std::pmr::monotonic_buffer_resource _chars;
+    // Views of the interned keys
+    std::pmr::unordered_set<std::string_view> _keys;
+    // Statistics for monitoring
+    size_t _lookups = 0;
+    size_t _hits = 0;
+};
+
+}  // namespace SimpleJson
+
+#endif  // SIMPLEJSON_KEYTABLE_H
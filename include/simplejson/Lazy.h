@@ -0,0 +1,96 @@
+#ifndef SIMPLEJSON_LAZY_H
+#define SIMPLEJSON_LAZY_H
+
+#include <string>
+#include <string_view>
+
+#include "Reader.h"
+#include "Value.h"
+
+namespace SimpleJson {
+
+class LazyDocument;
+
+/// A value of a LazyDocument, found by scanning forward through the text.
+/// Navigating skips the members and elements passed over without building
+/// or converting them, and only checks that their brackets and quotation
+/// marks match; a value is parsed and validated in full when it is read.
+/// A member of a non-object or an element of a non-array does not exist.
+/// A value that is not good() is missing, with an Ok result, or follows an
+/// error met while scanning, which the values navigated to from it keep.
+/// @note reading a value that is not good() throws std::out_of_range, and
+///       one that fails to parse throws std::invalid_argument
+class LazyValue {
+public:
+    [[nodiscard]] bool good() const { return _pCur != nullptr; }
+    [[nodiscard]] ParseResult result() const { return _result; }
+
+    /// the member `key`, the last one if repeated as parse keeps it, so the
+    /// object is scanned to its end
+    [[nodiscard]] LazyValue operator[](std::string_view key) const;
+    /// the element at `index`
+    [[nodiscard]] LazyValue operator[](size_t index) const;
+
+    [[nodiscard]] ValueType type() const;
+    [[nodiscard]] bool isNull() const { return type() == ValueType::Null; }
+    [[nodiscard]] Bool asBool() const { return toValue().asBool(); }
+    [[nodiscard]] Integer asInteger() const { return toValue().asInteger(); }
+    [[nodiscard]] UInteger asUInteger() const {
+        return toValue().asUInteger();
+    }
+    [[nodiscard]] Real asReal() const { return toValue().asReal(); }
+    [[nodiscard]] std::string asString() const {
+        return toValue().asString();
+    }
+    /// parse the whole value, e.g. a subtree to keep
+    [[nodiscard]] Value toValue() const;
+
+private:
+    friend class LazyDocument;
+    LazyValue(LazyDocument* document, const char* pCur, ParseResult result)
+        : _document(document), _pCur(pCur), _result(result) {}
+    [[nodiscard]] LazyValue missing() const;
+    [[nodiscard]] LazyValue error(ParseResult errorType) const;
+    void checkGood() const;
+
+private:
+    LazyDocument* _document = nullptr;
+    // Start of the value, null if it is missing or scanning failed
+    const char* _pCur = nullptr;
+    ParseResult _result = ParseResult::Ok;
+};
+
+/// On-demand access to a few values of a large document, see LazyValue.
+/// Only the text scanned on the way to the values read is checked, and the
+/// document is not required to end after the root.
+/// @note the document is not copied, and must outlive this and its values
+class LazyDocument {
+public:
+    explicit LazyDocument(const char* pDocument);
+    explicit LazyDocument(const std::string& document);
+    // a temporary would be gone before its values are read
+    LazyDocument(std::string&&) = delete;
+    LazyDocument(const LazyDocument&) = delete;
+    LazyDocument& operator=(const LazyDocument&) = delete;
+
+    [[nodiscard]] LazyValue root();
+    [[nodiscard]] LazyValue operator[](std::string_view key) {
+        return root()[key];
+    }
+    [[nodiscard]] LazyValue operator[](size_t index) {
+        return root()[index];
+    }
+
+private:
+    friend class LazyValue;
+
+    const char* _pBegin;
+    // End of document, followed by a NUL
+    const char* _pEnd;
+    // Parses the values read
+    Reader _reader;
+};
+
+}  // namespace SimpleJson
+
+#endif  // SIMPLEJSON_LAZY_H
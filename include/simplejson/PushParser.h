@@ -0,0 +1,136 @@
+#ifndef SIMPLEJSON_PUSHPARSER_H
+#define SIMPLEJSON_PUSHPARSER_H
+
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Reader.h"
+#include "Value.h"
+
+namespace SimpleJson {
+
+/// Parses a document delivered in chunks, e.g. as it is received, into a
+/// value or into events to a handler, see BaseHandler. A chunk may end
+/// anywhere, within a string, an escape or a number: the parser keeps its
+/// state in between, holding back only the string or number not complete
+/// yet, and the value, events and errors are those of Reader::parse of the
+/// whole document. finish() ends the document, and the parser is ready for
+/// another one.
+/// @note on error, feed() and finish() return false until the next document
+class PushParser {
+public:
+    /// build the document into `root` as it arrives, allocating from
+    /// `resource`; it is complete once finish() succeeds, and null on error
+    explicit PushParser(
+        Value& root,
+        Value::MemoryResource* resource = std::pmr::get_default_resource());
+    /// deliver the events of the document to `handler`
+    /// @note the handler must outlive the parser
+    template <typename Handler>
+    explicit PushParser(Handler& handler)
+        : _sink(std::make_unique<HandlerSink<Handler>>(handler)) {}
+    PushParser(const PushParser&) = delete;
+    PushParser& operator=(const PushParser&) = delete;
+
+    /// parse the next chunk of the document
+    bool feed(std::string_view chunk);
+    /// the document is complete, parse what was held back
+    bool finish();
+    [[nodiscard]] bool good() const { return _result == ParseResult::Ok; }
+    [[nodiscard]] ParseResult result() const { return _result; }
+
+private:
+    // events to a handler of any type, or to a value
+    struct Sink {
+        virtual ~Sink() = default;
+        virtual void onNull() = 0;
+        virtual void onBool(Bool val) = 0;
+        virtual void onInteger(Integer val) = 0;
+        virtual void onUInteger(UInteger val) = 0;
+        virtual void onReal(Real val) = 0;
+        virtual void onString(std::string_view str) = 0;
+        virtual void onStartArray() = 0;
+        virtual void onEndArray(size_t size) = 0;
+        virtual void onStartObject() = 0;
+        virtual void onKey(std::string_view key) = 0;
+        virtual void onEndObject(size_t size) = 0;
+        /// the document failed, the next one starts over
+        virtual void fail() {}
+    };
+    template <typename Handler>
+    struct HandlerSink;
+    class ValueSink;
+    struct TokenSink;
+
+    // what the next char is parsed as
+    enum class State {
+        Value,
+        FirstElement,
+        FirstMember,
+        Key,
+        Colon,
+        Next,
+        String,
+        Bare,
+    };
+    // an array or object not closed yet
+    struct Frame {
+        bool object;
+        size_t size;
+    };
+
+    const char* parseStructure(const char* p, const char* pEnd);
+    const char* scanString(const char* p, const char* pEnd);
+    const char* scanBare(const char* p, const char* pEnd);
+    void startValue(char c);
+    void startString(bool key);
+    void parseToken();
+    void endValue();
+    void close();
+    void endDocument();
+    void error(ParseResult errorType);
+
+private:
+    std::unique_ptr<Sink> _sink;
+    State _state = State::Value;
+    // Containers not closed yet, innermost last
+    std::vector<Frame> _open;
+    // Text of the string or number parsed, up to the end of the chunks so far
+    std::string _token;
+    // Whether the string parsed is a key
+    bool _key = false;
+    // Whether the next char of the string parsed is escaped
+    bool _escaped = false;
+    ParseResult _result = ParseResult::Ok;
+    // Whether the next chunk starts another document
+    bool _finished = false;
+    // Parses each string or number, once complete
+    Reader _reader;
+};
+
+template <typename Handler>
+struct PushParser::HandlerSink final : Sink {
+    explicit HandlerSink(Handler& handler) : handler(handler) {}
+    void onNull() override { handler.onNull(); }
+    void onBool(const Bool val) override { handler.onBool(val); }
+    void onInteger(const Integer val) override { handler.onInteger(val); }
+    void onUInteger(const UInteger val) override { handler.onUInteger(val); }
+    void onReal(const Real val) override { handler.onReal(val); }
+    void onString(const std::string_view str) override {
+        handler.onString(str);
+    }
+    void onStartArray() override { handler.onStartArray(); }
+    void onEndArray(const size_t size) override { handler.onEndArray(size); }
+    void onStartObject() override { handler.onStartObject(); }
+    void onKey(const std::string_view key) override { handler.onKey(key); }
+    void onEndObject(const size_t size) override { handler.onEndObject(size); }
+
+    Handler& handler;
+};
+
+}  // namespace SimpleJson
+
+#endif  // SIMPLEJSON_PUSHPARSER_H
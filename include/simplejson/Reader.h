@@ -1,8 +1,14 @@
 #ifndef SIMPLEJSON_READER_H
 #define SIMPLEJSON_READER_H
 
+#include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <string>
+#include <string_view>
+#include <vector>
 
+#include "KeyTable.h"
 #include "Value.h"
 
 namespace SimpleJson {
@@ -23,41 +29,463 @@ enum class [[nodiscard]] ParseResult{
     MissKey,
     MissColon,
     MissCurlyBracket,
+    InvalidFile,
+    DepthExceeded,
+};
+
+/// Events of a parse without a value tree, for Reader::parse with a handler.
+/// A handler provides the same member functions, called in document order;
+/// one deriving from this needs to define only those it is interested in.
+/// Strings and keys are views valid only during the call.
+struct BaseHandler {
+    void onNull() {}
+    void onBool(Bool /*val*/) {}
+    void onInteger(Integer /*val*/) {}
+    void onUInteger(UInteger /*val*/) {}
+    void onReal(Real /*val*/) {}
+    void onString(std::string_view /*str*/) {}
+    void onStartArray() {}
+    /// `size` elements were parsed
+    void onEndArray(size_t /*size*/) {}
+    void onStartObject() {}
+    /// the value of the member follows
+    void onKey(std::string_view /*key*/) {}
+    /// `size` members were parsed
+    void onEndObject(size_t /*size*/) {}
 };
 
 class Reader {
 public:
+    /// arrays and objects nested deeper fail with DepthExceeded, see
+    /// setMaxDepth()
+    static constexpr size_t DEFAULT_MAX_DEPTH = 1024;
+
+    Reader() = default;
+    /// allocate parsed values from `resource`, e.g. an arena
+    explicit Reader(Value::MemoryResource* resource) : _resource(resource) {}
+    /// also intern object keys in `keyTable`
+    Reader(Value::MemoryResource* resource, KeyTable* keyTable)
+        : _resource(resource), _keyTable(keyTable) {}
+
     bool parse(const char* pDocument, Value& root);
-    bool parse(const std::string& document, Value& root) {
-        return parse(document.data(), root);
+    /// the document need not be terminated: it is parsed in place, but for
+    /// the whitespace, number or literal it ends with, parsed from a copy
+    bool parse(const char* pDocument, size_t length, Value& root);
+    bool parse(std::string_view document, Value& root) {
+        return parse(document.data(), document.size(), root);
     }
+    /// parse the first `length` chars of a buffer of `capacity`, e.g. one a
+    /// network read filled: the char past the document is set to the NUL
+    /// the grammar stops on, and the document is parsed in place, or as an
+    /// unterminated one if there is no room for it
+    bool parse(char* pBuffer, size_t length, size_t capacity, Value& root);
+    bool parse(const std::string& document, Value& root);
+    bool parseFile(const std::string& path, Value& root);
+    /// parse in situ: strings become views into the document, those with
+    /// escapes are unescaped over their source text
+    /// @note the document is modified, and must outlive the parsed values
+    bool parseInsitu(char* pDocument, Value& root);
+    bool parseInsitu(std::string& document, Value& root);
+    /// parse in two stages: find the structural chars of the whole document
+    /// with vector instructions, then build the value from their positions,
+    /// passing over whitespace without reading it; same results as parse
+    /// @note keeps room for 4 bytes per char of the document between parses
+    bool parseIndexed(const std::string& document, Value& root);
+    /// parse a document whose root is a large array on `threadCount`
+    /// threads: find the elements from the structural chars, as
+    /// parseIndexed does, and parse them in batches, each in its place in
+    /// `root`; any other document, or one failing, is parsed as by parse,
+    /// so the values and errors are the same
+    /// @note values are allocated by several threads at once only from the
+    ///       default resource, with any other, e.g. an arena, it is parsed
+    ///       as by parse
+    bool parseParallel(const std::string& document, Value& root,
+                       unsigned threadCount);
+    /// parse only the values at `pointers`, JSON Pointers (RFC 6901) such as
+    /// "/header/tenant", into `root`: the containers on the way keep the
+    /// members found, and the elements found at their index, after nulls;
+    /// anything else is skipped by matching brackets and quotation marks
+    /// only, like a LazyDocument, up to the end of the root, which must be
+    /// the end of the document. As by parse, a repeated key leads to its
+    /// last member, and a missing value is left out, the root being null
+    /// if nothing is found.
+    /// @throw std::invalid_argument if a pointer is malformed
+    bool parseProjected(const std::string& document,
+                        const std::vector<std::string_view>& pointers,
+                        Value& root);
+    /// parse into events to `handler` instead of a value, see BaseHandler;
+    /// on error, the events so far have been delivered and no more follow
+    template <typename Handler>
+    bool parse(const char* pDocument, Handler& handler);
+    template <typename Handler>
+    bool parse(const char* pDocument, size_t length, Handler& handler);
+    template <typename Handler>
+    bool parse(char* pBuffer, size_t length, size_t capacity,
+               Handler& handler);
+    template <typename Handler>
+    bool parse(const std::string& document, Handler& handler);
+    /// parse the value at the start of [pBegin, pEnd) into events, leaving
+    /// the rest unparsed; return the char past the value, or null on error
+    /// @note `pEnd` must point to a NUL
+    template <typename Handler>
+    const char* parsePrefix(const char* pBegin, const char* pEnd,
+                            Handler& handler);
     [[nodiscard]] bool good() const { return _result == ParseResult::Ok; }
     [[nodiscard]] ParseResult result() const { return _result; }
+    /// the most arrays and objects a value may be nested in, the root
+    /// counting as one; no parse takes stack for them, nor discarding the
+    /// value of one failed, but a Value nested much deeper than the default
+    /// exhausts it when copied, compared or destroyed, so a handler suits
+    /// such documents better
+    void setMaxDepth(size_t maxDepth) { _maxDepth = maxDepth; }
+    [[nodiscard]] size_t maxDepth() const { return _maxDepth; }
 
 private:
+    // an array or object not closed yet
+    struct Frame {
+        bool object;
+        size_t size;
+    };
+
+    // a number converted into the type a Value would hold it as
+    struct ScannedNumber {
+        ValueType type = ValueType::Integer;
+        Integer integer = 0;
+        UInteger uinteger = 0;
+        Real real = 0;
+    };
+
+    bool parseTree(const char* pBegin, const char* pEnd, Value& root,
+                   bool terminated = true);
+    template <typename Handler>
+    bool parseBuffer(const char* pBegin, const char* pEnd, Handler& handler,
+                     bool terminated = true);
+    template <typename Handler>
+    void parseValue(Handler& handler);
+    template <typename Handler>
+    void parseScalar(Handler& handler);
+    template <typename Handler>
+    void parseNumber(Handler& handler);
+    template <typename Handler>
+    bool parseNext(Handler& handler);
+    template <typename Handler>
+    bool parseIndex(const char* pBegin, const char* pEnd, Handler& handler);
+    template <typename Handler>
+    void parseIndexedValue(Handler& handler);
+    template <typename Handler>
+    bool parseIndexedNext(Handler& handler);
+    [[nodiscard]] const char* peekToken() const { return _pBegin + *_pToken; }
+    [[nodiscard]] const char* nextToken() { return _pBegin + *_pToken++; }
     void skipWhitespace();
-    [[nodiscard]] Value error(ParseResult errorType);
-    [[nodiscard]] Value parseValue();
-    [[nodiscard]] Value parseLiteral(std::string_view literal, Value value);
-    [[nodiscard]] Value parseNumber();
-    [[nodiscard]] Value parseInteger(const char* numberEnd);
-    [[nodiscard]] Value parseReal(const char* numberEnd);
-    [[nodiscard]] ParseResult parseString();
+    [[nodiscard]] static const char* findTail(const char* pBegin,
+                                              const char* pEnd);
+    void copyTail();
+    void error(ParseResult errorType);
+    [[nodiscard]] bool parseLiteral(std::string_view literal);
+    [[nodiscard]] bool scanNumber(ScannedNumber& number);
+    [[nodiscard]] bool parseStringValue(std::string_view& str);
+    [[nodiscard]] std::string_view placeInsitu(std::string_view str,
+                                               const char* pSource);
+    [[nodiscard]] ParseResult parseString(std::string_view& str);
     [[nodiscard]] ParseResult parseEscaped();
     [[nodiscard]] ParseResult parseUnicode();
     void encodeUnicode(unsigned codePoint);
-    [[nodiscard]] Value parseArray();
-    [[nodiscard]] Value parseObject();
 
 private:
     // Current location of document, valid only during parsing
     const char* _pCur = nullptr;
+    // End of document, followed by a NUL once `_pCur` reaches `_pLimit`,
+    // valid only during parsing
+    const char* _pEnd = nullptr;
+    // Start of the chars parsed from `_docBuf` if the document is not
+    // terminated, else past the end, valid only during parsing
+    const char* _pLimit = nullptr;
+    // Start of document, valid only during indexed parsing
+    const char* _pBegin = nullptr;
+    // Next position in `_index`, valid only during indexed parsing
+    const uint32_t* _pToken = nullptr;
     // Result of last round of parsing
     ParseResult _result = ParseResult::Ok;
+    // Whether strings are kept in the document, valid only during parsing
+    bool _insitu = false;
+    // Resource of parsed values
+    Value::MemoryResource* _resource = std::pmr::get_default_resource();
+    // Table of object keys, copied into each object if null
+    KeyTable* _keyTable = nullptr;
     // Buffer of string
     std::string _strBuf;
+    // Terminated copy of the end of a document given by length
+    std::string _docBuf;
+    // Positions of the structural chars of the document, then its end
+    std::vector<uint32_t> _index;
+    // Containers not closed yet, innermost last, valid only during parsing
+    std::vector<Frame> _stack;
+    size_t _maxDepth = DEFAULT_MAX_DEPTH;
 };
 
+template <typename Handler>
+bool Reader::parse(const char* const pDocument, Handler& handler) {
+    if (pDocument == nullptr) {
+        error(ParseResult::ExpectValue);
+        return false;
+    }
+    return parseBuffer(pDocument, pDocument + std::strlen(pDocument), handler);
+}
+
+template <typename Handler>
+bool Reader::parse(const char* const pDocument, const size_t length,
+                   Handler& handler) {
+    if (pDocument == nullptr) {
+        error(ParseResult::ExpectValue);
+        return false;
+    }
+
+    return parseBuffer(pDocument, pDocument + length, handler, false);
+}
+
+template <typename Handler>
+bool Reader::parse(char* const pBuffer, const size_t length,
+                   const size_t capacity, Handler& handler) {
+    if (pBuffer == nullptr || capacity <= length) {
+        return parse(static_cast<const char*>(pBuffer), length, handler);
+    }
+
+    // terminate the document in the room past it, and parse it in place
+    pBuffer[length] = 0;
+    return parseBuffer(pBuffer, pBuffer + length, handler);
+}
+
+template <typename Handler>
+bool Reader::parse(const std::string& document, Handler& handler) {
+    // std::string is always NUL-terminated, parse it in place
+    return parseBuffer(document.data(), document.data() + document.size(),
+                       handler);
+}
+
+/// JSON = ws value ws
+/// if not `terminated`, the tail a scan could run past the end over is
+/// parsed from a terminated copy
+template <typename Handler>
+bool Reader::parseBuffer(const char* const pBegin, const char* const pEnd,
+                         Handler& handler, const bool terminated) {
+    assert(pBegin != nullptr && pBegin <= pEnd);
+    assert(!terminated || *pEnd == 0);
+
+    // set context
+    _pCur = pBegin;
+    _pEnd = pEnd;
+    _pLimit = terminated ? pEnd + 1 : findTail(pBegin, pEnd);
+    _result = ParseResult::Ok;
+
+    // parsing
+    skipWhitespace();
+    parseValue(handler);
+    if (good()) {
+        skipWhitespace();
+        if (_pCur != _pEnd) {
+            error(ParseResult::RootNotSingular);
+        }
+    }
+
+    _pCur = nullptr;
+    _pEnd = nullptr;
+    _pLimit = nullptr;
+    return good();
+}
+
+/// ws value
+template <typename Handler>
+const char* Reader::parsePrefix(const char* const pBegin,
+                                const char* const pEnd, Handler& handler) {
+    assert(pBegin != nullptr && pBegin <= pEnd);
+    assert(*pEnd == 0);
+
+    // set context
+    _pCur = pBegin;
+    _pEnd = pEnd;
+    _pLimit = pEnd + 1;
+    _result = ParseResult::Ok;
+
+    // parsing
+    skipWhitespace();
+    parseValue(handler);
+    const auto pNext = good() ? _pCur : nullptr;
+
+    _pCur = nullptr;
+    _pEnd = nullptr;
+    _pLimit = nullptr;
+    return pNext;
+}
+
+/// value = null / true / false / number / string / array / object
+/// arrays and objects are parsed in this loop, on `_stack`, rather than by
+/// recursion, so that no nesting exhausts the call stack
+template <typename Handler>
+void Reader::parseValue(Handler& handler) {
+    assert(_pCur != nullptr);
+
+    _stack.clear();
+    do {
+        const char c = *_pCur;
+        if (c == '[' || c == '{') {
+            // begin of array or object, its elements or members follow
+            if (_stack.size() == _maxDepth) {
+                error(ParseResult::DepthExceeded);
+                return;
+            }
+            ++_pCur;
+            const bool object = c == '{';
+            if (object) {
+                handler.onStartObject();
+            } else {
+                handler.onStartArray();
+            }
+            _stack.push_back({object, 0});
+        } else {
+            parseScalar(handler);
+            if (!good()) {
+                return;
+            }
+            if (_stack.empty()) {
+                return;
+            }
+            ++_stack.back().size;
+        }
+    } while (parseNext(handler));
+}
+
+/// null / true / false / number / string
+template <typename Handler>
+void Reader::parseScalar(Handler& handler) {
+    assert(_pCur != nullptr);
+
+    switch (*_pCur) {
+        case '\0':
+            error(_pCur == _pEnd ? ParseResult::ExpectValue
+                                 : ParseResult::InvalidValue);
+            break;
+        case 'n':
+            if (parseLiteral("null")) {
+                handler.onNull();
+            }
+            break;
+        case 't':
+            if (parseLiteral("true")) {
+                handler.onBool(true);
+            }
+            break;
+        case 'f':
+            if (parseLiteral("false")) {
+                handler.onBool(false);
+            }
+            break;
+        case '"': {
+            std::string_view str;
+            if (parseStringValue(str)) {
+                handler.onString(str);
+            }
+            break;
+        }
+        default:
+            parseNumber(handler);
+            break;
+    }
+}
+
+/// number = [ "-" ] int [ frac ] [ exp ]
+template <typename Handler>
+void Reader::parseNumber(Handler& handler) {
+    ScannedNumber number;
+    if (!scanNumber(number)) {
+        return;
+    }
+    switch (number.type) {
+        case ValueType::Integer:
+            handler.onInteger(number.integer);
+            break;
+        case ValueType::UInteger:
+            handler.onUInteger(number.uinteger);
+            break;
+        default:
+            handler.onReal(number.real);
+            break;
+    }
+}
+
+/// array = %x5B ws [ value *( ws %x2C ws value ) ] ws %x5D
+/// object = %x7B ws [ member *( ws %x2C ws member ) ] ws %x7D
+/// member = string ws %x3A ws value
+/// past the start or a value of the innermost container, close it and those
+/// it ends, up to the next value; return whether one follows
+template <typename Handler>
+bool Reader::parseNext(Handler& handler) {
+    while (!_stack.empty()) {
+        const auto frame = _stack.back();
+        skipWhitespace();
+        if (_pCur == _pEnd) {
+            // end of document
+            error(frame.object ? ParseResult::MissCurlyBracket
+                               : ParseResult::MissSquareBracket);
+            return false;
+        }
+        const char c = *_pCur;
+        if (c == (frame.object ? '}' : ']')) {
+            // end of array or object, a value of its parent
+            ++_pCur;
+            _stack.pop_back();
+            if (frame.object) {
+                handler.onEndObject(frame.size);
+            } else {
+                handler.onEndArray(frame.size);
+            }
+            if (!_stack.empty()) {
+                ++_stack.back().size;
+            }
+            continue;
+        }
+        if (frame.size != 0) {
+            // expect comma
+            if (c != ',') {
+                error(ParseResult::MissComma);
+                return false;
+            }
+            ++_pCur;
+            skipWhitespace();
+        }
+        if (!frame.object) {
+            // parse element
+            return true;
+        }
+
+        // parse key
+        if (*_pCur != '"') {
+            error(ParseResult::MissKey);
+            return false;
+        }
+        std::string_view key;
+        if (auto res = parseString(key); res != ParseResult::Ok) {
+            error(res);
+            return false;
+        }
+        // the key is handed over before parsing the value reuses the buffer
+        handler.onKey(key);
+
+        // ':'
+        skipWhitespace();
+        if (*_pCur != ':') {
+            error(ParseResult::MissColon);
+            return false;
+        }
+        ++_pCur;
+        skipWhitespace();
+
+        // parse value
+        return true;
+    }
+    // the root is complete
+    return false;
+}
+
 }  // namespace SimpleJson
 
 #endif  // SIMPLEJSON_READER_H
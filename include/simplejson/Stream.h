@@ -0,0 +1,58 @@
+#ifndef SIMPLEJSON_STREAM_H
+#define SIMPLEJSON_STREAM_H
+
+#include <string>
+#include <vector>
+
+#include "Reader.h"
+#include "Value.h"
+
+namespace SimpleJson {
+
+/// Parses the values of one buffer in turn, e.g. newline-delimited JSON
+/// (NDJSON, JSON Lines) or values simply concatenated, with whitespace
+/// between them or none where it is not needed. An error stops the stream
+/// at the value failed, with the ParseResult of Reader::parse of it.
+/// @note the buffer is not copied, and must outlive this
+class DocumentStream {
+public:
+    /// the size of a batch parsed by a worker, see parseAll()
+    static constexpr size_t DEFAULT_BATCH_SIZE = 1 << 20;
+
+    explicit DocumentStream(const char* pBuffer);
+    explicit DocumentStream(const std::string& buffer);
+    // a temporary would be gone before its values are parsed
+    DocumentStream(std::string&&) = delete;
+    DocumentStream(const DocumentStream&) = delete;
+    DocumentStream& operator=(const DocumentStream&) = delete;
+
+    /// parse the next value into `value`; return false at the end of the
+    /// buffer, or on error, see result()
+    bool next(Value& value);
+    /// parse the values left, appended to `values` in order; with several
+    /// threads, the buffer is split after a newline into batches of about
+    /// `batchSize` chars, parsed on up to `threadCount` threads
+    /// @note a batch starting within a value, which spans lines, is parsed
+    ///       again after the previous one, so the values and errors are
+    ///       those of next() in any case
+    bool parseAll(std::vector<Value>& values, unsigned threadCount = 1,
+                  size_t batchSize = DEFAULT_BATCH_SIZE);
+    [[nodiscard]] bool good() const { return _result == ParseResult::Ok; }
+    [[nodiscard]] ParseResult result() const { return _result; }
+    /// the offset of the next value in the buffer, or of the one failed
+    [[nodiscard]] size_t offset() const { return _pCur - _pBegin; }
+
+private:
+    const char* _pBegin;
+    // Start of the next value, or whitespace before it
+    const char* _pCur;
+    // End of buffer, followed by a NUL
+    const char* _pEnd;
+    ParseResult _result = ParseResult::Ok;
+    // Parses each value, in turn
+    Reader _reader;
+};
+
+}  // namespace SimpleJson
+
+#endif  // SIMPLEJSON_STREAM_H
@@ -0,0 +1,168 @@
+#ifndef SIMPLEJSON_TAPE_H
+#define SIMPLEJSON_TAPE_H
+
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Reader.h"
+#include "Value.h"
+
+namespace SimpleJson {
+
+class TapeDocument;
+class TapeIterator;
+
+/// A value of a TapeDocument, a position on its tape.
+/// Elements and members are found by a linear scan that jumps over the
+/// values passed; a member is the last one if its key is repeated, as
+/// Reader::parse keeps. To visit all of them, iterate instead, see
+/// TapeIterator.
+/// @note like Value, a type mismatch throws std::bad_variant_access, and a
+///       missing member or element std::out_of_range
+class TapeValue {
+public:
+    [[nodiscard]] ValueType type() const;
+    [[nodiscard]] bool isNull() const { return type() == ValueType::Null; }
+    [[nodiscard]] bool isBool() const { return type() == ValueType::Bool; }
+    [[nodiscard]] bool isInteger() const {
+        return type() == ValueType::Integer;
+    }
+    [[nodiscard]] bool isUInteger() const {
+        return type() == ValueType::UInteger;
+    }
+    [[nodiscard]] bool isReal() const { return type() == ValueType::Real; }
+    [[nodiscard]] bool isString() const { return type() == ValueType::String; }
+    [[nodiscard]] bool isArray() const { return type() == ValueType::Array; }
+    [[nodiscard]] bool isObject() const { return type() == ValueType::Object; }
+
+    [[nodiscard]] Bool asBool() const;
+    [[nodiscard]] Integer asInteger() const;
+    [[nodiscard]] UInteger asUInteger() const;
+    [[nodiscard]] Real asReal() const;
+
+    // string
+    [[nodiscard]] std::string_view asStringView() const;
+    [[nodiscard]] std::string asString() const;
+    [[nodiscard]] const char* asCString() const;
+
+    // array & object
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] bool empty() const;
+
+    // array
+    [[nodiscard]] TapeValue operator[](size_t index) const;
+
+    // object
+    [[nodiscard]] TapeValue operator[](std::string_view key) const;
+    [[nodiscard]] bool isMember(std::string_view key) const;
+    [[nodiscard]] std::string_view getMemberName(size_t index) const;
+    [[nodiscard]] TapeValue getMemberValue(size_t index) const;
+
+    // array & object, in document order
+    [[nodiscard]] TapeIterator begin() const;
+    [[nodiscard]] TapeIterator end() const;
+
+    /// a copy to modify, allocated from `resource`
+    [[nodiscard]] Value toValue(
+        Value::MemoryResource* resource = std::pmr::get_default_resource())
+        const;
+
+private:
+    friend class TapeDocument;
+    friend class TapeIterator;
+    TapeValue(const TapeDocument* document, size_t pos)
+        : _document(document), _pos(pos) {}
+    [[nodiscard]] uint64_t word(size_t offset = 0) const;
+    [[nodiscard]] uint64_t payload() const;
+    [[nodiscard]] size_t next() const;
+    void checkType(ValueType type) const;
+    /// the position of the key of member `key`, or 0 if missing
+    [[nodiscard]] size_t findMember(std::string_view key) const;
+    /// the position of the key of member `index`
+    [[nodiscard]] size_t memberAt(size_t index) const;
+
+private:
+    const TapeDocument* _document;
+    // Position of the first word of the value
+    size_t _pos;
+};
+
+/// Iterates the elements of an array, or the values of the members of an
+/// object with key() naming each, a jump over the previous one at a time.
+class TapeIterator {
+public:
+    [[nodiscard]] TapeValue operator*() const {
+        return TapeValue(_document, _member ? _pos + 2 : _pos);
+    }
+    TapeIterator& operator++();
+    [[nodiscard]] bool operator==(const TapeIterator& other) const {
+        return _pos == other._pos;
+    }
+    [[nodiscard]] bool operator!=(const TapeIterator& other) const {
+        return _pos != other._pos;
+    }
+    /// the key of the member, for an object
+    [[nodiscard]] std::string_view key() const;
+
+private:
+    friend class TapeValue;
+    TapeIterator(const TapeDocument* document, size_t pos, bool member)
+        : _document(document), _pos(pos), _member(member) {}
+
+    const TapeDocument* _document;
+    // Position of the element, or of the key of the member
+    size_t _pos;
+    bool _member;
+};
+
+/// A read-only document parsed into one contiguous tape of 64-bit words,
+/// with the chars of strings and keys in a side buffer.
+/// A value is a word of its type and a payload, in document order: null
+/// and bools take that word, numbers a second one with their bits, strings
+/// a second one with their size after the offset of their chars, and
+/// arrays and objects a second one with their size after the position past
+/// their end, followed by their elements, or their members as a key string
+/// and a value. Reading walks the tape front to back instead of chasing
+/// pointers between allocations, and passes over a container in one jump.
+/// @note values refer to the document, which must outlive them; toValue
+///       copies one to modify
+class TapeDocument {
+public:
+    TapeDocument() = default;
+    TapeDocument(const TapeDocument&) = delete;
+    TapeDocument& operator=(const TapeDocument&) = delete;
+
+    /// parse `document` into the tape, replacing what it held; on error the
+    /// root is null, see result()
+    bool parse(const char* pDocument);
+    bool parse(const std::string& document);
+    [[nodiscard]] bool good() const { return _reader.good(); }
+    [[nodiscard]] ParseResult result() const { return _reader.result(); }
+
+    [[nodiscard]] TapeValue root() const { return TapeValue(this, 0); }
+    [[nodiscard]] TapeValue operator[](std::string_view key) const {
+        return root()[key];
+    }
+    [[nodiscard]] TapeValue operator[](size_t index) const {
+        return root()[index];
+    }
+
+private:
+    friend class TapeValue;
+    template <typename Source>
+    bool parseInto(const Source& source);
+
+    // Values in document order, a null before any parse
+    std::vector<uint64_t> _tape = std::vector<uint64_t>(1);
+    // Chars of strings and keys, each followed by a NUL
+    std::string _strings;
+    // Parses into the tape
+    Reader _reader;
+};
+
+}  // namespace SimpleJson
+
+#endif  // SIMPLEJSON_TAPE_H
@@ -1,37 +1,66 @@
 #ifndef SIMPLEJSON_VALUE_H
 #define SIMPLEJSON_VALUE_H
 
-#include <map>
+#include <array>
+#include <cstdint>
+#include <cstring>
 #include <memory>
+#include <memory_resource>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <variant>
 #include <vector>
 
 namespace SimpleJson {
 
-enum class [[nodiscard]] ValueType{Null,   Bool,  Integer, Real,
-                                   String, Array, Object};
+enum class [[nodiscard]] ValueType{Null, Bool,   Integer, UInteger,
+                                   Real, String, Array,   Object};
 
 using Bool = bool;
 using Integer = long long;
+using UInteger = unsigned long long;
 using Real = double;
 
+/// Strings, arrays and objects are allocated from a std::pmr memory resource,
+/// the default resource unless one is given. Values of a tree parsed or
+/// copied into an arena such as std::pmr::monotonic_buffer_resource do no
+/// frees when destroyed, and the arena releases all of them at once.
+/// An integer is an Integer when it fits, and an UInteger only above that
+/// range, so equal integers always have the same type.
+/// Object members keep their insertion order, which getMemberNames, the
+/// member accessors by index and Writer follow.
+/// @note a value must not outlive the resource it is allocated from
 class [[nodiscard]] Value {
 public:
+    using MemoryResource = std::pmr::memory_resource;
+
     // ctor
     Value() = default;
-    explicit Value(ValueType type);
+    explicit Value(ValueType type)
+        : Value(type, std::pmr::get_default_resource()) {}
+    Value(ValueType type, MemoryResource* resource);
     Value(Bool val) : _data(val) {}
     Value(Integer val) : _data(val) {}
+    Value(UInteger val);
     template <typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
-    Value(T val) : Value(Integer(val)) {}
+    Value(T val)
+        : Value(std::conditional_t<std::is_unsigned_v<T>, UInteger, Integer>(
+              val)) {}
     Value(Real val) : _data(val) {}
-    Value(std::string_view str) : _data(String(str)) {}
+    Value(std::string_view str)
+        : Value(str, std::pmr::get_default_resource()) {}
+    Value(std::string_view str, MemoryResource* resource)
+        : _data(String(str, resource)) {}
     Value(const char* str) : Value(std::string_view(str)) {}
     Value(const std::string& str) : Value(std::string_view(str)) {}
+    /// a string referring to `str` instead of a copy, so are copies of it
+    /// @note `str` must be followed by a NUL and outlive all those values
+    [[nodiscard]] static Value view(std::string_view str);
 
-    Value(const Value& other);
+    Value(const Value& other)
+        : Value(other, std::pmr::get_default_resource()) {}
+    Value(const Value& other, MemoryResource* resource);
     Value(Value && other) = default;
 
     Value& operator=(Value other);
@@ -53,6 +82,9 @@ public:
     [[nodiscard]] bool isInteger() const {
         return std::holds_alternative<Integer>(_data);
     }
+    [[nodiscard]] bool isUInteger() const {
+        return std::holds_alternative<UInteger>(_data);
+    }
     [[nodiscard]] bool isReal() const {
         return std::holds_alternative<Real>(_data);
     }
@@ -68,6 +100,9 @@ public:
 
     [[nodiscard]] Bool asBool() const { return std::get<Bool>(_data); }
     [[nodiscard]] Integer asInteger() const { return std::get<Integer>(_data); }
+    [[nodiscard]] UInteger asUInteger() const {
+        return std::get<UInteger>(_data);
+    }
     [[nodiscard]] Real asReal() const { return std::get<Real>(_data); }
 
     // string
@@ -87,29 +122,138 @@ public:
     void append(Value value);
 
     // object
-    [[nodiscard]] Value& operator[](const std::string& key);
-    [[nodiscard]] const Value& operator[](const std::string& key) const;
-    [[nodiscard]] bool isMember(const std::string& key) const;
-    [[nodiscard]] Value removeMember(const std::string& key);
+    [[nodiscard]] Value& operator[](std::string_view key);
+    [[nodiscard]] const Value& operator[](std::string_view key) const;
+    /// like operator[], but a missing member refers to `key` instead of a
+    /// copy, and lookups by the same chars skip comparing them
+    /// @note `key` must be followed by a NUL and outlive the value
+    [[nodiscard]] Value& viewMember(std::string_view key);
+    [[nodiscard]] bool isMember(std::string_view key) const;
+    [[nodiscard]] Value removeMember(std::string_view key);
     [[nodiscard]] std::vector<std::string> getMemberNames() const;
+    [[nodiscard]] std::string_view getMemberName(size_t index) const;
+    [[nodiscard]] const Value& getMemberValue(size_t index) const;
 
 private:
     struct Null {};
-    using Array = std::vector<Value>;
-    using Object = std::map<std::string, Value>;
-    using PArray = std::unique_ptr<Array>;
-    using PObject = std::unique_ptr<Object>;
+    using Array = std::pmr::vector<Value>;
+    class Object;
+    // frees a container with the resource it is allocated from
+    struct Deleter {
+        template <typename T>
+        void operator()(T* ptr) const;
+    };
+    using PArray = std::unique_ptr<Array, Deleter>;
+    using PObject = std::unique_ptr<Object, Deleter>;
+    // short strings are stored inline, longer ones out of line
     class String {
     public:
-        String() = default;
-        explicit String(std::string_view str);
+        String() { _storage.back() = INLINE_CAPACITY; }
+        String(std::string_view str, MemoryResource* resource);
+        /// a view stays a view
+        String(const String& other, MemoryResource* resource);
+        [[nodiscard]] static String view(std::string_view str);
+        String(const String&) = delete;
+        String(String&& other) noexcept;
+        String& operator=(const String&) = delete;
+        String& operator=(String&& other) noexcept;
+        ~String();
         [[nodiscard]] operator std::string_view() const {
-            return std::string_view(_ptr.get(), _size);
+            if (this->isInline()) {
+                const size_t size = INLINE_CAPACITY - this->tag();
+                return size == 0 ? std::string_view()
+                                 : std::string_view(_storage.data(), size);
+            }
+            return std::string_view(this->pointer(), this->outOfLineSize());
+        }
+        [[nodiscard]] bool isInline() const {
+            return this->tag() <= INLINE_CAPACITY;
+        }
+        [[nodiscard]] bool isView() const { return this->tag() == VIEW_TAG; }
+
+    private:
+        static constexpr size_t STORAGE_SIZE = 16;
+        static constexpr unsigned char INLINE_CAPACITY = STORAGE_SIZE - 1;
+        // tags of out-of-line chars, owned or referred to
+        static constexpr unsigned char OWNED_TAG = 0x40;
+        static constexpr unsigned char VIEW_TAG = 0x41;
+        // bytes of the out-of-line size, between the pointer and the tag
+        static constexpr size_t SIZE_BYTES = 7;
+        static_assert(sizeof(char*) + SIZE_BYTES < STORAGE_SIZE);
+
+        [[nodiscard]] unsigned char tag() const {
+            return static_cast<unsigned char>(_storage.back());
+        }
+        [[nodiscard]] const char* pointer() const {
+            const char* ptr = nullptr;
+            std::memcpy(&ptr, _storage.data(), sizeof(ptr));
+            return ptr;
+        }
+        [[nodiscard]] size_t outOfLineSize() const {
+            uint64_t size = 0;
+            for (size_t i = 0; i < SIZE_BYTES; ++i) {
+                const auto byte = static_cast<unsigned char>(
+                    _storage[sizeof(char*) + i]);
+                size |= uint64_t(byte) << (8U * i);
+            }
+            return static_cast<size_t>(size);
+        }
+        void setOutOfLine(const char* ptr, size_t size, unsigned char tag);
+
+        // inline: the chars and a NUL, with `INLINE_CAPACITY - size` in the
+        // last byte, which is also the NUL of a full string
+        // out of line: the pointer, the size as little-endian bytes and a
+        // tag; owned chars and a NUL are preceded by the resource they are
+        // allocated from
+        alignas(char*) std::array<char, STORAGE_SIZE> _storage{};
+    };
+
+    // members in insertion order, found by a linear scan while there are
+    // few of them and by a hash index of their positions beyond that
+    class Object {
+    public:
+        using Member = std::pair<String, Value>;
+        using allocator_type = std::pmr::polymorphic_allocator<Member>;
+        static constexpr size_t NPOS = ~size_t(0);
+
+        explicit Object(MemoryResource* resource)
+            : _members(resource), _index(resource) {}
+        [[nodiscard]] allocator_type get_allocator() const {
+            return _members.get_allocator();
+        }
+
+        [[nodiscard]] size_t size() const { return _members.size(); }
+        [[nodiscard]] bool empty() const { return _members.empty(); }
+        [[nodiscard]] auto begin() const { return _members.begin(); }
+        [[nodiscard]] auto end() const { return _members.end(); }
+        [[nodiscard]] Member& operator[](size_t index) {
+            return _members[index];
+        }
+        [[nodiscard]] const Member& operator[](size_t index) const {
+            return _members[index];
         }
 
+        /// the position of `key`, or NPOS
+        [[nodiscard]] size_t find(std::string_view key) const;
+        /// the value of `key`, appended as null if missing
+        [[nodiscard]] Value& operator[](std::string_view key);
+        /// `key` must not be a member yet
+        Value& append(String key, Value value);
+        void erase(size_t index);
+        void clear();
+        void reserve(size_t size) { _members.reserve(size); }
+
     private:
-        std::unique_ptr<char[]> _ptr;  // NOLINT(modernize-avoid-c-arrays)
-        size_t _size = 0;
+        void indexMember(size_t index);
+        void rebuildIndex();
+
+        // members up to this many are scanned linearly
+        static constexpr size_t LINEAR_MAX = 8;
+
+        std::pmr::vector<Member> _members;
+        // positions of members plus one, placed by hash of their keys with
+        // linear probing, empty while members are scanned linearly
+        std::pmr::vector<uint32_t> _index;
     };
 
 private:
@@ -123,9 +267,17 @@ private:
     }
 
 private:
-    std::variant<Null, Bool, Integer, Real, String, PArray, PObject> _data;
+    std::variant<Null, Bool, Integer, UInteger, Real, String, PArray, PObject>
+        _data;
 };
 
+template <typename T>
+void Value::Deleter::operator()(T* const ptr) const {
+    std::pmr::polymorphic_allocator<T> allocator(ptr->get_allocator());
+    ptr->~T();
+    allocator.deallocate(ptr, 1);
+}
+
 }  // namespace SimpleJson
 
 #endif  // SIMPLEJSON_VALUE_H
@@ -1,7 +1,11 @@
 #ifndef SIMPLEJSON_WRITER_H
 #define SIMPLEJSON_WRITER_H
 
+#include <cstdio>
+#include <functional>
+#include <iosfwd>
 #include <string>
+#include <string_view>
 
 #include "simplejson/Value.h"
 
@@ -9,17 +13,62 @@ namespace SimpleJson {
 
 class Writer {
 public:
+    /// receives the document in consecutive chunks
+    using Sink = std::function<void(std::string_view chunk)>;
+    /// chunks handed to a sink are about this size, except for the last
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+    /// arrays and objects of fewer elements or members are written on one
+    /// thread, see Writer(unsigned, size_t)
+    static constexpr size_t PARALLEL_THRESHOLD = 4096;
+
+    Writer() = default;
+    /// write each array or object of at least `parallelThreshold` elements
+    /// or members on `threadCount` threads: slices of it are written into
+    /// buffers of their own, then joined in order into the same document
+    /// as on one thread
+    /// @note for a sink, slices of about `parallelThreshold` elements or
+    ///       members are written a wave of `threadCount` at a time, each
+    ///       handed over in chunks before the next wave, so the memory held
+    ///       is that of a wave rather than of the whole container
+    explicit Writer(unsigned threadCount,
+                    size_t parallelThreshold = PARALLEL_THRESHOLD)
+        : _threadCount(threadCount), _parallelThreshold(parallelThreshold) {}
+
     std::string write(const Value& root);
+    /// append to `document`, so that repeated writes reuse its capacity
+    /// @note if writing throws, `document` keeps its contents, and perhaps
+    ///       part of the output after them
+    void write(const Value& root, std::string& document);
+    /// write in chunks, so that memory stays bounded however large the
+    /// document is
+    void write(const Value& root, const Sink& sink);
+    /// return whether all chunks were written
+    bool write(const Value& root, std::ostream& os);
+    bool write(const Value& root, std::FILE* file);
 
 private:
     void stringifyValue(const Value& root);
+    /// Integer or UInteger, formatted without a temporary string
+    template <typename T>
+    void stringifyInteger(T number);
     void stringifyReal(Real number);
     void stringifyString(std::string_view str);
     void stringifyArray(const Value& root);
     void stringifyObject(const Value& root);
+    /// elements or members [first, last), separated by commas
+    void stringifyElements(const Value& root, size_t first, size_t last);
+    void stringifyMembers(const Value& root, size_t first, size_t last);
+    void stringifyParallel(const Value& root);
+    void appendSlice(std::string_view slice);
+    void flushChunk();
 
 private:
     std::string _strBuf;
+    // Threads writing a large container, and the size it takes
+    unsigned _threadCount = 1;
+    size_t _parallelThreshold = PARALLEL_THRESHOLD;
+    // Destination of full chunks, valid only during writing to a sink
+    const Sink* _sink = nullptr;
 };
 
 }  // namespace SimpleJson
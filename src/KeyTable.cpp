@@ -0,0 +1,25 @@
+#include "simplejson/KeyTable.h"
+
+namespace SimpleJson {
+
+std::string_view KeyTable::intern(const std::string_view key) {
+    ++_lookups;
+    if (const auto it = _keys.find(key); it != _keys.end()) {
+        ++_hits;
+        return *it;
+    }
+
+    auto* const chars = static_cast<char*>(_chars.allocate(key.size() + 1, 1));
+    key.copy(chars, key.size());
+    chars[key.size()] = 0;
+    return *_keys.emplace(chars, key.size()).first;
+}
+
+double KeyTable::hitRate() const {
+    if (_lookups == 0) {
+        return 0;
+    }
+    return static_cast<double>(_hits) / static_cast<double>(_lookups);
+}
+
+}  // namespace SimpleJson
@@ -0,0 +1,207 @@
+#include "simplejson/Lazy.h"
+
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+#include "Simd.h"
+#include "Skip.h"
+#include "ValueBuilder.h"
+
+// helpers
+namespace {
+
+/// captures a string parsed, e.g. a key with escapes
+struct StringCapture : SimpleJson::BaseHandler {
+    void onString(const std::string_view str) { this->str = str; }
+    std::string str;
+};
+
+/// ws = *(%x20 / %x09 / %x0A / %x0D), return the first char past `ws`
+const char* skipWhitespace(const char* p);
+
+}  // namespace
+
+namespace SimpleJson {
+
+LazyDocument::LazyDocument(const char* const pDocument)
+    : _pBegin(pDocument), _pEnd(pDocument + std::strlen(pDocument)) {}
+
+LazyDocument::LazyDocument(const std::string& document)
+    : _pBegin(document.data()), _pEnd(document.data() + document.size()) {}
+
+LazyValue LazyDocument::root() {
+    const auto p = skipWhitespace(_pBegin);
+    if (p == _pEnd) {
+        return LazyValue(this, nullptr, ParseResult::ExpectValue);
+    }
+    return LazyValue(this, p, ParseResult::Ok);
+}
+
+/// object = %x7B ws [ member *( ws %x2C ws member ) ] ws %x7D
+LazyValue LazyValue::operator[](const std::string_view key) const {
+    if (!good()) {
+        return *this;
+    }
+    if (*_pCur != '{') {
+        return missing();
+    }
+
+    // the last member `key`, as parse keeps it, so scan to the end
+    const auto pEnd = _document->_pEnd;
+    const char* pFound = nullptr;
+    auto p = _pCur + 1;
+    for (bool first = true;; first = false) {
+        p = skipWhitespace(p);
+        if (p == pEnd) {
+            return error(ParseResult::MissCurlyBracket);
+        }
+        if (*p == '}') {
+            return pFound != nullptr
+                       ? LazyValue(_document, pFound, ParseResult::Ok)
+                       : missing();
+        }
+        if (!first) {
+            if (*p != ',') {
+                return error(ParseResult::MissComma);
+            }
+            p = skipWhitespace(p + 1);
+        }
+
+        // member = string ws %x3A ws value
+        if (*p != '"') {
+            return error(ParseResult::MissKey);
+        }
+        bool match = false;
+        if (const auto pQuote = Simd::scanString(p + 1); *pQuote == '"') {
+            // no escapes, compare the text
+            match = std::string_view(p + 1, pQuote - p - 1) == key;
+            p = pQuote + 1;
+        } else {
+            StringCapture capture;
+            auto& reader = _document->_reader;
+            p = reader.parsePrefix(p, pEnd, capture);
+            if (p == nullptr) {
+                return error(reader.result());
+            }
+            match = capture.str == key;
+        }
+        p = skipWhitespace(p);
+        if (*p != ':') {
+            return error(ParseResult::MissColon);
+        }
+        p = skipWhitespace(p + 1);
+        if (match) {
+            pFound = p;
+        }
+
+        auto res = ParseResult::Ok;
+        p = skipValue(p, pEnd, res);
+        if (p == nullptr) {
+            return error(res);
+        }
+    }
+}
+
+/// array = %x5B ws [ value *( ws %x2C ws value ) ] ws %x5D
+LazyValue LazyValue::operator[](const size_t index) const {
+    if (!good()) {
+        return *this;
+    }
+    if (*_pCur != '[') {
+        return missing();
+    }
+
+    const auto pEnd = _document->_pEnd;
+    auto p = _pCur + 1;
+    for (size_t i = 0;; ++i) {
+        p = skipWhitespace(p);
+        if (p == pEnd) {
+            return error(ParseResult::MissSquareBracket);
+        }
+        if (*p == ']') {
+            return missing();
+        }
+        if (i != 0) {
+            if (*p != ',') {
+                return error(ParseResult::MissComma);
+            }
+            p = skipWhitespace(p + 1);
+        }
+        if (i == index) {
+            return LazyValue(_document, p, ParseResult::Ok);
+        }
+
+        auto res = ParseResult::Ok;
+        p = skipValue(p, pEnd, res);
+        if (p == nullptr) {
+            return error(res);
+        }
+    }
+}
+
+ValueType LazyValue::type() const {
+    checkGood();
+    switch (*_pCur) {
+        case 'n':
+            return ValueType::Null;
+        case 't':
+        case 'f':
+            return ValueType::Bool;
+        case '"':
+            return ValueType::String;
+        case '[':
+            return ValueType::Array;
+        case '{':
+            return ValueType::Object;
+        default:
+            // which kind of number it is takes converting it
+            return toValue().type();
+    }
+}
+
+Value LazyValue::toValue() const {
+    checkGood();
+    Value value;
+    ValueBuilder builder(value, std::pmr::get_default_resource(), nullptr,
+                         false);
+    if (_document->_reader.parsePrefix(_pCur, _document->_pEnd, builder) ==
+        nullptr) {
+        throw std::invalid_argument("invalid value");
+    }
+    return value;
+}
+
+LazyValue LazyValue::missing() const {
+    return LazyValue(_document, nullptr, ParseResult::Ok);
+}
+
+LazyValue LazyValue::error(const ParseResult errorType) const {
+    assert(errorType != ParseResult::Ok);
+    return LazyValue(_document, nullptr, errorType);
+}
+
+void LazyValue::checkGood() const {
+    if (!good()) {
+        throw std::out_of_range(_result == ParseResult::Ok
+                                    ? "no such value"
+                                    : "invalid document before the value");
+    }
+}
+
+}  // namespace SimpleJson
+
+// ===== helpers =====
+namespace {
+
+const char* skipWhitespace(const char* p) {
+    if (SimpleJson::Simd::isWhitespace(*p)) {
+        ++p;
+        if (SimpleJson::Simd::isWhitespace(*p)) {
+            p = SimpleJson::Simd::skipWhitespace(p);
+        }
+    }
+    return p;
+}
+
+}  // namespace
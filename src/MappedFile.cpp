@@ -0,0 +1,96 @@
+#include "MappedFile.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SIMPLEJSON_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+namespace SimpleJson {
+
+#ifdef SIMPLEJSON_MMAP
+
+MappedFile::MappedFile(const char* const path) {
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return;
+    }
+
+    struct stat status {};
+    if (::fstat(fd, &status) != 0 || !S_ISREG(status.st_mode)) {
+        ::close(fd);
+        return;
+    }
+
+    _size = static_cast<size_t>(status.st_size);
+    if (_size == 0) {
+        // nothing to map
+        ::close(fd);
+        _data = _buffer.c_str();
+        return;
+    }
+
+    // the rest of the last page reads as zeros, unless there is no rest,
+    // then reserve one more zero page and map the file over the front
+    const auto pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const bool padded = _size % pageSize == 0;
+    const auto mappedSize = padded ? _size + pageSize : _size;
+
+    void* address = nullptr;
+    if (padded) {
+        address = ::mmap(nullptr, mappedSize, PROT_READ,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (address != MAP_FAILED &&
+            ::mmap(address, _size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd,
+                   0) == MAP_FAILED) {
+            ::munmap(address, mappedSize);
+            address = MAP_FAILED;
+        }
+    } else {
+        address = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        return;
+    }
+
+    // parsing reads the file once from front to back
+    ::madvise(address, _size, MADV_SEQUENTIAL);
+
+    _data = static_cast<const char*>(address);
+    _mappedSize = mappedSize;
+}
+
+MappedFile::~MappedFile() {
+    if (_mappedSize != 0) {
+        ::munmap(const_cast<char*>(_data), _mappedSize);
+    }
+}
+
+#else  // SIMPLEJSON_MMAP
+
+// no mmap on this platform, read the file instead
+MappedFile::MappedFile(const char* const path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return;
+    }
+    _buffer.assign(std::istreambuf_iterator<char>(file),
+                   std::istreambuf_iterator<char>());
+    if (file.bad()) {
+        return;
+    }
+    _data = _buffer.c_str();
+    _size = _buffer.size();
+}
+
+MappedFile::~MappedFile() = default;
+
+#endif  // SIMPLEJSON_MMAP
+
+}  // namespace SimpleJson
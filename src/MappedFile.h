@@ -0,0 +1,35 @@
+#ifndef SIMPLEJSON_MAPPEDFILE_H
+#define SIMPLEJSON_MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+namespace SimpleJson {
+
+/// Read-only contents of a whole file, always followed by a NUL
+/// @note memory-mapped where supported, so the file must not be truncated
+///       while it is open
+class MappedFile {
+public:
+    explicit MappedFile(const char* path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] bool good() const { return _data != nullptr; }
+    [[nodiscard]] const char* data() const { return _data; }
+    [[nodiscard]] size_t size() const { return _size; }
+
+private:
+    const char* _data = nullptr;
+    size_t _size = 0;
+    // Length of the mapping, 0 if the file is not mapped
+    size_t _mappedSize = 0;
+    // Contents of a file which is not mapped
+    std::string _buffer;
+};
+
+}  // namespace SimpleJson
+
+#endif  // SIMPLEJSON_MAPPEDFILE_H
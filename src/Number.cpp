@@ -0,0 +1,814 @@
+#include "Number.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#include "PowersOfFive.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// helpers
+namespace {
+
+/// digit = %x30-39
+bool isDigit(char c);
+
+/// accumulate the integer digits from `p` into `mantissa`, flag `truncated`
+/// past the uint64_t range, and return the char past them
+const char* scanInteger(const char* p, uint64_t& mantissa, bool& truncated);
+
+/// accumulate the fraction digits from `p` into `mantissa` while they fit,
+/// scaling `exponent` down by one for each, flag `truncated` if a dropped
+/// one is not 0, and return the char past them
+const char* scanFraction(const char* p, uint64_t& mantissa,
+                         int32_t& exponent, bool& truncated);
+
+/// the exact mantissa * 10^exponent, if both are small enough for it to be
+/// a single correctly rounded operation on doubles
+bool convertClinger(uint64_t mantissa, int32_t exponent, double& res);
+
+/// the correctly rounded mantissa * 10^exponent, unless undecidable
+bool convertEiselLemire(uint64_t mantissa, int32_t exponent, double& res);
+
+/// a decimal of up to DIGITS_MAX significant digits, 0.d1d2d3... * 10^point,
+/// for exact arithmetic by shifts
+struct Decimal {
+    // enough for the exact value of any double, and for rounding halfway
+    // between two of them
+    static constexpr uint32_t DIGITS_MAX = 768;
+    // a shift by up to 60 bits adds as many digits at most
+    static constexpr uint32_t SHIFT_MAX = 60;
+    static constexpr uint32_t SHIFT_DIGITS_MAX = 19;
+
+    uint32_t count = 0;
+    int32_t point = 0;
+    // nonzero digits past DIGITS_MAX were dropped
+    bool truncated = false;
+    // with room for the digits a left shift adds before they are in place
+    std::array<uint8_t, DIGITS_MAX + SHIFT_DIGITS_MAX> digits{};
+};
+
+/// the decimal digits and exponent of the number at `str`, without a sign
+Decimal parseDecimal(const char* str);
+
+/// append `digit`, or flag the decimal truncated if there is no room
+void appendDigit(Decimal& decimal, uint8_t digit);
+
+/// drop trailing zero digits
+void trimDecimal(Decimal& decimal);
+
+/// multiply by 2^shift, shift up to SHIFT_MAX
+void shiftLeft(Decimal& decimal, uint32_t shift);
+
+/// divide by 2^shift, shift up to SHIFT_MAX
+void shiftRight(Decimal& decimal, uint32_t shift);
+
+/// the first `point` digits as an integer, rounded to nearest, ties to
+/// even, i.e. the integer part if `point` is that of the decimal
+uint64_t roundDecimal(const Decimal& decimal, int32_t point);
+
+/// the exact decimal of mantissa * 10^exponent
+Decimal makeDecimal(uint64_t mantissa, int32_t exponent);
+
+/// the correctly rounded mantissa * 10^exponent, by the fastest algorithm
+/// that decides it
+double convertExact(uint64_t mantissa, int32_t exponent);
+
+/// the exact decimal of finite, positive `number`
+Decimal exactDecimal(double number);
+
+/// the correctly rounded double of `decimal`, which is modified
+double convertDecimal(Decimal& decimal);
+
+/// the 128-bit product of `lhs` and `rhs`
+void multiply(uint64_t lhs, uint64_t rhs, uint64_t& high, uint64_t& low);
+
+/// the number of leading zero bits, `value` must not be zero
+int countLeadingZeros(uint64_t value);
+
+}  // namespace
+
+namespace SimpleJson::Number {
+
+Scanned scan(const char* const str) {
+    assert(str != nullptr);
+    Scanned res;
+    auto p = str;
+
+    // [ "-" ]
+    if (*p == '-') {
+        res.negative = true;
+        ++p;
+    }
+
+    // int = "0" / digit1-9 *digit
+    if (*p == '0') {
+        ++p;
+    } else if (*p >= '1' && *p <= '9') {
+        p = scanInteger(p, res.mantissa, res.truncated);
+    } else {
+        return res;
+    }
+    constexpr auto INTEGER_MAX =
+        static_cast<uint64_t>(std::numeric_limits<Integer>::max());
+    res.type = !res.negative && (res.truncated || res.mantissa > INTEGER_MAX)
+                   ? Type::UInteger
+                   : Type::Integer;
+
+    // frac = "." 1*digit
+    if (*p == '.') {
+        ++p;
+        if (!isDigit(*p)) {
+            res.type = Type::Nan;
+            return res;
+        }
+        p = scanFraction(p, res.mantissa, res.exponent, res.truncated);
+        res.type = Type::Real;
+    }
+
+    // exp = ("e" / "E") ["-" / "+"] 1*digit
+    if (*p == 'e' || *p == 'E') {
+        ++p;
+        bool negative = false;
+        if (*p == '-' || *p == '+') {
+            negative = *p == '-';
+            ++p;
+        }
+        if (!isDigit(*p)) {
+            res.type = Type::Nan;
+            return res;
+        }
+        // far beyond any double, and so never overflows
+        constexpr int32_t EXPONENT_MAX = 100'000;
+        int32_t exponent = 0;
+        while (isDigit(*p)) {
+            if (exponent < EXPONENT_MAX) {
+                exponent = exponent * 10 + (*p - '0');
+            }
+            ++p;
+        }
+        res.exponent += negative ? -exponent : exponent;
+        res.type = Type::Real;
+    }
+
+    res.end = p;
+    return res;
+}
+
+ParseResult toInteger(const Scanned& number, Integer& value) {
+    assert(number.type == Type::Integer);
+    constexpr auto INTEGER_MAX =
+        static_cast<uint64_t>(std::numeric_limits<Integer>::max());
+
+    if (number.truncated) {
+        return ParseResult::NumberOverflow;
+    }
+    if (!number.negative) {
+        value = static_cast<Integer>(number.mantissa);
+        return ParseResult::Ok;
+    }
+    if (number.mantissa <= INTEGER_MAX) {
+        value = -static_cast<Integer>(number.mantissa);
+        return ParseResult::Ok;
+    }
+    if (number.mantissa == INTEGER_MAX + 1) {
+        value = std::numeric_limits<Integer>::min();
+        return ParseResult::Ok;
+    }
+    return ParseResult::NumberOverflow;
+}
+
+ParseResult toUInteger(const Scanned& number, UInteger& value) {
+    assert(number.type == Type::UInteger);
+    if (number.truncated) {
+        return ParseResult::NumberOverflow;
+    }
+    value = number.mantissa;
+    return ParseResult::Ok;
+}
+
+ParseResult toReal(const char* const str, const Scanned& number,
+                   Real& value) {
+    assert(str != nullptr);
+    assert(number.type == Type::Real);
+
+    Real res = 0;
+    if (number.truncated ||
+        (!convertClinger(number.mantissa, number.exponent, res) &&
+         !convertEiselLemire(number.mantissa, number.exponent, res))) {
+        return toRealDecimal(str, number, value);
+    }
+
+    // overflow
+    if (std::isinf(res)) {
+        return ParseResult::NumberOverflow;
+    }
+
+    value = number.negative ? -res : res;
+    return ParseResult::Ok;
+}
+
+ParseResult toRealDecimal(const char* const str, const Scanned& number,
+                          Real& value) {
+    assert(str != nullptr);
+    assert(number.type == Type::Real);
+
+    // all the digits, in exact arithmetic
+    auto decimal = parseDecimal(str);
+    const auto res = convertDecimal(decimal);
+
+    // overflow
+    if (std::isinf(res)) {
+        return ParseResult::NumberOverflow;
+    }
+
+    value = number.negative ? -res : res;
+    return ParseResult::Ok;
+}
+
+size_t toShortest(const Real number, char* const digits, int32_t& point) {
+    assert(std::isfinite(number) && number > 0);
+    constexpr int32_t DIGITS_MAX = std::numeric_limits<Real>::max_digits10;
+    const auto exact = exactDecimal(number);
+
+    // the fewest digits that, rounded, read back the same, by bisection as
+    // more digits never read back further from the number
+    const auto readsBack = [&](const int32_t count) {
+        return convertExact(roundDecimal(exact, count), exact.point - count) ==
+               number;
+    };
+    int32_t low = 1;
+    int32_t high = DIGITS_MAX;
+    while (low < high) {
+        const auto count = (low + high) / 2;
+        if (readsBack(count)) {
+            high = count;
+        } else {
+            low = count + 1;
+        }
+    }
+
+    // rounding up may carry into one more digit, e.g. 9.96 to 10.0
+    auto rounded = roundDecimal(exact, low);
+    while (rounded % 10 == 0) {
+        rounded /= 10;
+        --low;
+    }
+    std::array<char, DIGITS_MAX + 1> reversed{};
+    size_t length = 0;
+    for (; rounded > 0; rounded /= 10) {
+        reversed[length++] = static_cast<char>('0' + rounded % 10);
+    }
+    std::reverse_copy(reversed.begin(), reversed.begin() + length, digits);
+    point = exact.point - low + static_cast<int32_t>(length);
+    return length;
+}
+
+size_t toIntegral(const Real number, char* const digits) {
+    assert(std::isfinite(number) && number > 0);
+    assert(number == std::floor(number) && number < INTEGRAL_MAX);
+    const auto exact = exactDecimal(number);
+    const auto length = static_cast<size_t>(exact.point);
+    for (size_t i = 0; i < length; ++i) {
+        digits[i] = static_cast<char>('0' + (i < exact.count ? exact.digits[i]
+                                                             : 0));
+    }
+    return length;
+}
+
+}  // namespace SimpleJson::Number
+
+// ===== helpers =====
+namespace {
+
+bool isDigit(const char c) {
+    return c >= '0' && c <= '9';
+}
+
+const char* scanInteger(const char* p, uint64_t& mantissa, bool& truncated) {
+    // up to 19 digits never overflow uint64_t
+    constexpr auto SAFE_DIGITS = 19;
+    constexpr auto MAX = std::numeric_limits<uint64_t>::max();
+
+    const auto begin = p;
+    uint64_t res = 0;
+    while (isDigit(*p)) {
+        const auto digit = static_cast<uint64_t>(*p - '0');
+        if (p - begin >= SAFE_DIGITS &&
+            (p - begin > SAFE_DIGITS || res > (MAX - digit) / 10)) {
+            truncated = true;
+        } else {
+            res = res * 10 + digit;
+        }
+        ++p;
+    }
+    mantissa = res;
+    return p;
+}
+
+const char* scanFraction(const char* p, uint64_t& mantissa,
+                         int32_t& exponent, bool& truncated) {
+    // any digit can be appended up to this
+    constexpr auto SAFE_MAX = (std::numeric_limits<uint64_t>::max() - 9) / 10;
+
+    auto res = mantissa;
+    auto scale = exponent;
+    while (isDigit(*p)) {
+        const auto digit = static_cast<uint64_t>(*p - '0');
+        if (res <= SAFE_MAX) {
+            res = res * 10 + digit;
+            --scale;
+        } else if (digit != 0) {
+            truncated = true;
+        }
+        ++p;
+    }
+    mantissa = res;
+    exponent = scale;
+    return p;
+}
+
+bool convertClinger(const uint64_t mantissa, const int32_t exponent,
+                    double& res) {
+#if FLT_EVAL_METHOD == 0
+    // 10^22 is the largest power of ten exact in a double
+    constexpr int32_t EXACT_POWER_MAX = 22;
+    constexpr uint64_t EXACT_MANTISSA_MAX = uint64_t(1) << 53U;
+    constexpr std::array<double, EXACT_POWER_MAX + 1> POWERS_OF_TEN = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    if (mantissa > EXACT_MANTISSA_MAX || exponent < -EXACT_POWER_MAX ||
+        exponent > EXACT_POWER_MAX) {
+        return false;
+    }
+    const auto value = static_cast<double>(mantissa);
+    res = exponent < 0 ? value / POWERS_OF_TEN[-exponent]
+                       : value * POWERS_OF_TEN[exponent];
+    return true;
+#else
+    // intermediate results may carry extra precision, and round twice
+    (void)mantissa;
+    (void)exponent;
+    (void)res;
+    return false;
+#endif
+}
+
+bool convertEiselLemire(uint64_t mantissa, const int32_t exponent,
+                        double& res) {
+    // binary64: 52 explicit mantissa bits and an exponent bias of 1023
+    constexpr int MANTISSA_BITS = 52;
+    constexpr int EXPONENT_BIAS = 1023;
+    constexpr int INFINITE_POWER = 0x7FF;
+    // products in this range of exponents may be exactly halfway
+    constexpr int32_t ROUND_TO_EVEN_MIN = -4;
+    constexpr int32_t ROUND_TO_EVEN_MAX = 23;
+    // products in this range of exponents are exact
+    constexpr int32_t EXACT_PRODUCT_MIN = -27;
+    constexpr int32_t EXACT_PRODUCT_MAX = 55;
+
+    const auto makeDouble = [&res](const uint64_t bits, const int power) {
+        const auto word = bits | static_cast<uint64_t>(power) << MANTISSA_BITS;
+        std::memcpy(&res, &word, sizeof(res));
+        return true;
+    };
+
+    if (mantissa == 0 || exponent < SimpleJson::Number::POWER_OF_FIVE_MIN) {
+        return makeDouble(0, 0);
+    }
+    if (exponent > SimpleJson::Number::POWER_OF_FIVE_MAX) {
+        return makeDouble(0, INFINITE_POWER);
+    }
+
+    // normalize the mantissa, and multiply by the truncated power of five
+    const auto leadingZeros = countLeadingZeros(mantissa);
+    mantissa <<= leadingZeros;
+    const auto& power = SimpleJson::Number::POWERS_OF_FIVE
+        [static_cast<size_t>(exponent - SimpleJson::Number::POWER_OF_FIVE_MIN)];
+    uint64_t high = 0;
+    uint64_t low = 0;
+    multiply(mantissa, power.high, high, low);
+    // the low bits below the mantissa are all ones, the truncation matters
+    constexpr uint64_t PRECISION_MASK =
+        std::numeric_limits<uint64_t>::max() >> (MANTISSA_BITS + 3U);
+    if ((high & PRECISION_MASK) == PRECISION_MASK) {
+        uint64_t secondHigh = 0;
+        uint64_t secondLow = 0;
+        multiply(mantissa, power.low, secondHigh, secondLow);
+        low += secondHigh;
+        if (secondHigh > low) {
+            ++high;
+        }
+    }
+    if (low == std::numeric_limits<uint64_t>::max() &&
+        (exponent < EXACT_PRODUCT_MIN || exponent > EXACT_PRODUCT_MAX)) {
+        // undecidable
+        return false;
+    }
+
+    // one bit more than the mantissa, for rounding
+    const auto upperBit = static_cast<int>(high >> 63U);
+    const auto shift = upperBit + 64 - MANTISSA_BITS - 3;
+    auto bits = high >> shift;
+    // floor(log2(10^exponent)) + 63, then biased
+    auto power2 = static_cast<int>(((152'170 + 65'536) * exponent) >> 16) +
+                  63 + upperBit - leadingZeros + EXPONENT_BIAS;
+
+    if (power2 <= 0) {
+        // subnormal
+        if (-power2 + 1 >= 64) {
+            return makeDouble(0, 0);
+        }
+        bits >>= -power2 + 1;
+        bits += bits & 1U;
+        bits >>= 1U;
+        power2 = bits < (uint64_t(1) << MANTISSA_BITS) ? 0 : 1;
+        return makeDouble(bits & ~(uint64_t(1) << MANTISSA_BITS), power2);
+    }
+
+    // exactly halfway between two doubles, round to even
+    if (low <= 1 && exponent >= ROUND_TO_EVEN_MIN &&
+        exponent <= ROUND_TO_EVEN_MAX && (bits & 3U) == 1 &&
+        (bits << shift) == high) {
+        bits &= ~uint64_t(1);
+    }
+    bits += bits & 1U;
+    bits >>= 1U;
+    if (bits >= (uint64_t(2) << MANTISSA_BITS)) {
+        // rounded up to the next power of two
+        bits = uint64_t(1) << MANTISSA_BITS;
+        ++power2;
+    }
+    if (power2 >= INFINITE_POWER) {
+        return makeDouble(0, INFINITE_POWER);
+    }
+    return makeDouble(bits & ~(uint64_t(1) << MANTISSA_BITS), power2);
+}
+
+Decimal parseDecimal(const char* p) {
+    // far beyond the points that round to zero or infinity, and so never
+    // overflows
+    constexpr int32_t POINT_MAX = 1'000'000;
+
+    Decimal res;
+    if (*p == '-') {
+        ++p;
+    }
+
+    // leading zeros are not significant
+    while (*p == '0') {
+        ++p;
+    }
+    int32_t point = 0;
+    while (isDigit(*p)) {
+        appendDigit(res, static_cast<uint8_t>(*p - '0'));
+        point = std::min(point + 1, POINT_MAX);
+        ++p;
+    }
+    if (*p == '.') {
+        ++p;
+        if (res.count == 0) {
+            while (*p == '0') {
+                point = std::max(point - 1, -POINT_MAX);
+                ++p;
+            }
+        }
+        while (isDigit(*p)) {
+            appendDigit(res, static_cast<uint8_t>(*p - '0'));
+            ++p;
+        }
+    }
+
+    // exp = ("e" / "E") ["-" / "+"] 1*digit
+    if (*p == 'e' || *p == 'E') {
+        ++p;
+        bool negative = false;
+        if (*p == '-' || *p == '+') {
+            negative = *p == '-';
+            ++p;
+        }
+        int32_t exponent = 0;
+        while (isDigit(*p)) {
+            if (exponent < POINT_MAX) {
+                exponent = exponent * 10 + (*p - '0');
+            }
+            ++p;
+        }
+        point += negative ? -exponent : exponent;
+    }
+
+    res.point = point;
+    trimDecimal(res);
+    return res;
+}
+
+void appendDigit(Decimal& decimal, const uint8_t digit) {
+    if (decimal.count < Decimal::DIGITS_MAX) {
+        decimal.digits[decimal.count++] = digit;
+    } else if (digit != 0) {
+        decimal.truncated = true;
+    }
+}
+
+void trimDecimal(Decimal& decimal) {
+    while (decimal.count > 0 && decimal.digits[decimal.count - 1] == 0) {
+        --decimal.count;
+    }
+}
+
+void shiftLeft(Decimal& decimal, const uint32_t shift) {
+    assert(shift <= Decimal::SHIFT_MAX);
+    if (decimal.count == 0) {
+        return;
+    }
+
+    // multiply from the last digit, writing each product digit as many
+    // places right as a shift may add, ahead of the digits still read
+    auto read = decimal.count;
+    auto write = decimal.count + Decimal::SHIFT_DIGITS_MAX;
+    uint64_t n = 0;
+    while (read > 0) {
+        n += static_cast<uint64_t>(decimal.digits[--read]) << shift;
+        decimal.digits[--write] = static_cast<uint8_t>(n % 10);
+        n /= 10;
+    }
+    while (n > 0) {
+        decimal.digits[--write] = static_cast<uint8_t>(n % 10);
+        n /= 10;
+    }
+
+    // move them in place
+    const auto added = Decimal::SHIFT_DIGITS_MAX - write;
+    auto count = decimal.count + added;
+    std::memmove(decimal.digits.data(), decimal.digits.data() + write, count);
+    if (count > Decimal::DIGITS_MAX) {
+        decimal.truncated =
+            decimal.truncated ||
+            std::any_of(decimal.digits.begin() + Decimal::DIGITS_MAX,
+                        decimal.digits.begin() + count,
+                        [](const uint8_t digit) { return digit != 0; });
+        count = Decimal::DIGITS_MAX;
+    }
+    decimal.count = count;
+    decimal.point += static_cast<int32_t>(added);
+    trimDecimal(decimal);
+}
+
+void shiftRight(Decimal& decimal, const uint32_t shift) {
+    assert(shift <= Decimal::SHIFT_MAX);
+
+    // the leading digits up to the first of the quotient
+    uint32_t read = 0;
+    uint64_t n = 0;
+    while ((n >> shift) == 0) {
+        if (read < decimal.count) {
+            n = n * 10 + decimal.digits[read++];
+        } else if (n == 0) {
+            // zero
+            return;
+        } else {
+            while ((n >> shift) == 0) {
+                n *= 10;
+                ++read;
+            }
+        }
+    }
+    decimal.point -= static_cast<int32_t>(read) - 1;
+
+    // divide digit by digit, the remainder carried to the next one
+    const auto mask = (uint64_t(1) << shift) - 1;
+    uint32_t write = 0;
+    while (read < decimal.count) {
+        const auto digit = static_cast<uint8_t>(n >> shift);
+        n = (n & mask) * 10 + decimal.digits[read++];
+        decimal.digits[write++] = digit;
+    }
+    while (n > 0) {
+        const auto digit = static_cast<uint8_t>(n >> shift);
+        n = (n & mask) * 10;
+        if (write < Decimal::DIGITS_MAX) {
+            decimal.digits[write++] = digit;
+        } else if (digit != 0) {
+            decimal.truncated = true;
+        }
+    }
+    decimal.count = write;
+    trimDecimal(decimal);
+}
+
+uint64_t roundDecimal(const Decimal& decimal, const int32_t point) {
+    constexpr int32_t DIGITS_MAX = 18;
+    if (decimal.count == 0 || point < 0) {
+        return 0;
+    }
+    if (point > DIGITS_MAX) {
+        return std::numeric_limits<uint64_t>::max();
+    }
+
+    const auto count = static_cast<uint32_t>(point);
+    uint64_t res = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        res = res * 10 + (i < decimal.count ? decimal.digits[i] : 0);
+    }
+    if (count < decimal.count) {
+        const auto digit = decimal.digits[count];
+        // exactly halfway only if nothing follows, then round to even
+        const bool halfway = digit == 5 && count + 1 == decimal.count &&
+                             !decimal.truncated;
+        if (halfway ? (res & 1U) != 0 : digit >= 5) {
+            ++res;
+        }
+    }
+    return res;
+}
+
+Decimal makeDecimal(uint64_t mantissa, const int32_t exponent) {
+    // the digits of the mantissa, last first
+    std::array<uint8_t, std::numeric_limits<uint64_t>::digits10 + 1> digits{};
+    uint32_t count = 0;
+    for (; mantissa > 0; mantissa /= 10) {
+        digits[count++] = static_cast<uint8_t>(mantissa % 10);
+    }
+
+    Decimal res;
+    std::reverse_copy(digits.begin(), digits.begin() + count,
+                      res.digits.begin());
+    res.count = count;
+    res.point = static_cast<int32_t>(count) + exponent;
+    trimDecimal(res);
+    return res;
+}
+
+double convertExact(const uint64_t mantissa, const int32_t exponent) {
+    double res = 0;
+    if (convertClinger(mantissa, exponent, res) ||
+        convertEiselLemire(mantissa, exponent, res)) {
+        return res;
+    }
+    auto decimal = makeDecimal(mantissa, exponent);
+    return convertDecimal(decimal);
+}
+
+Decimal exactDecimal(const double number) {
+    constexpr int MANTISSA_DIGITS = std::numeric_limits<double>::digits;
+
+    // an integer mantissa times a power of two, which no double has more
+    // digits of than a decimal keeps
+    int power2 = 0;
+    const auto mantissa = static_cast<uint64_t>(
+        std::ldexp(std::frexp(number, &power2), MANTISSA_DIGITS));
+    power2 -= MANTISSA_DIGITS;
+    auto res = makeDecimal(mantissa, 0);
+    while (power2 != 0) {
+        const auto shift = std::min(static_cast<uint32_t>(std::abs(power2)),
+                                    Decimal::SHIFT_MAX);
+        if (power2 > 0) {
+            shiftLeft(res, shift);
+            power2 -= static_cast<int>(shift);
+        } else {
+            shiftRight(res, shift);
+            power2 += static_cast<int>(shift);
+        }
+    }
+    assert(!res.truncated);
+    return res;
+}
+
+double convertDecimal(Decimal& decimal) {
+    // binary64: 52 explicit mantissa bits and an exponent bias of 1023
+    constexpr int MANTISSA_BITS = 52;
+    constexpr int32_t EXPONENT_BIAS = 1023;
+    constexpr int32_t INFINITE_POWER = 0x7FF;
+    // beyond these, the decimal is zero or infinite for a double
+    constexpr int32_t POINT_MIN = -324;
+    constexpr int32_t POINT_MAX = 310;
+    // the most bits a shift by 10^n takes, that keeps the point positive
+    constexpr std::array<uint32_t, 19> POWER_SHIFTS = {
+        0, 3, 6, 9, 13, 16, 19, 23, 26, 29, 33, 36, 39, 43, 46, 49, 53, 56, 59};
+
+    const auto makeDouble = [](const uint64_t bits, const int32_t power) {
+        const auto word = bits | static_cast<uint64_t>(power) << MANTISSA_BITS;
+        double res = 0;
+        std::memcpy(&res, &word, sizeof(res));
+        return res;
+    };
+    const auto shiftFor = [&](const uint32_t n) {
+        return n < POWER_SHIFTS.size() ? POWER_SHIFTS[n] : Decimal::SHIFT_MAX;
+    };
+
+    if (decimal.count == 0 || decimal.point < POINT_MIN) {
+        return makeDouble(0, 0);
+    }
+    if (decimal.point >= POINT_MAX) {
+        return makeDouble(0, INFINITE_POWER);
+    }
+
+    // scale into [1/2, 1), counting the power of two
+    int32_t power2 = 0;
+    while (decimal.point > 0) {
+        const auto shift = shiftFor(static_cast<uint32_t>(decimal.point));
+        shiftRight(decimal, shift);
+        power2 += static_cast<int32_t>(shift);
+    }
+    while (decimal.point <= 0) {
+        uint32_t shift = 0;
+        if (decimal.point == 0) {
+            if (decimal.digits[0] >= 5) {
+                break;
+            }
+            shift = decimal.digits[0] < 2 ? 2 : 1;
+        } else {
+            shift = shiftFor(static_cast<uint32_t>(-decimal.point));
+        }
+        shiftLeft(decimal, shift);
+        power2 -= static_cast<int32_t>(shift);
+    }
+    // a double is in [1, 2)
+    --power2;
+
+    // subnormal, the mantissa loses bits
+    while (power2 < 1 - EXPONENT_BIAS) {
+        const auto shift = std::min(
+            static_cast<uint32_t>(1 - EXPONENT_BIAS - power2),
+            Decimal::SHIFT_MAX);
+        shiftRight(decimal, shift);
+        power2 += static_cast<int32_t>(shift);
+    }
+    if (power2 + EXPONENT_BIAS >= INFINITE_POWER) {
+        return makeDouble(0, INFINITE_POWER);
+    }
+
+    // the mantissa with its implicit bit, rounded
+    shiftLeft(decimal, MANTISSA_BITS + 1);
+    auto mantissa = roundDecimal(decimal, decimal.point);
+    if (mantissa >= (uint64_t(2) << MANTISSA_BITS)) {
+        // rounded up to the next power of two
+        shiftRight(decimal, 1);
+        ++power2;
+        mantissa = roundDecimal(decimal, decimal.point);
+        if (power2 + EXPONENT_BIAS >= INFINITE_POWER) {
+            return makeDouble(0, INFINITE_POWER);
+        }
+    }
+    auto biased = power2 + EXPONENT_BIAS;
+    if (mantissa < (uint64_t(1) << MANTISSA_BITS)) {
+        // subnormal
+        --biased;
+    }
+    return makeDouble(mantissa & ~(uint64_t(1) << MANTISSA_BITS), biased);
+}
+
+void multiply(const uint64_t lhs, const uint64_t rhs, uint64_t& high,
+              uint64_t& low) {
+#if defined(__SIZEOF_INT128__)
+    // NOLINTNEXTLINE(modernize-use-using): no `using` form of __extension__
+    __extension__ typedef unsigned __int128 Uint128;
+    const auto product = static_cast<Uint128>(lhs) * rhs;
+    high = static_cast<uint64_t>(product >> 64U);
+    low = static_cast<uint64_t>(product);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    low = _umul128(lhs, rhs, &high);
+#else
+    // schoolbook on 32-bit halves
+    constexpr uint64_t HALF_MASK = 0xFFFF'FFFFU;
+    const auto lhsLow = lhs & HALF_MASK;
+    const auto lhsHigh = lhs >> 32U;
+    const auto rhsLow = rhs & HALF_MASK;
+    const auto rhsHigh = rhs >> 32U;
+    const auto lowLow = lhsLow * rhsLow;
+    const auto lowHigh = lhsLow * rhsHigh;
+    const auto highLow = lhsHigh * rhsLow;
+    const auto cross = (lowLow >> 32U) + (highLow & HALF_MASK) + lowHigh;
+    high = lhsHigh * rhsHigh + (highLow >> 32U) + (cross >> 32U);
+    low = (cross << 32U) | (lowLow & HALF_MASK);
+#endif
+}
+
+int countLeadingZeros(const uint64_t value) {
+    assert(value != 0);
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index = 0;
+    _BitScanReverse64(&index, value);
+    return 63 - static_cast<int>(index);
+#elif defined(_MSC_VER)
+    unsigned long index = 0;
+    if (_BitScanReverse(&index, static_cast<unsigned long>(value >> 32U))) {
+        return 31 - static_cast<int>(index);
+    }
+    _BitScanReverse(&index, static_cast<unsigned long>(value));
+    return 63 - static_cast<int>(index);
+#else
+    return __builtin_clzll(value);
+#endif
+}
+
+}  // namespace
@@ -0,0 +1,71 @@
+#ifndef SIMPLEJSON_NUMBER_H
+#define SIMPLEJSON_NUMBER_H
+
+// Internal scanning and conversion of numbers shared by the parsers, and
+// the shortest digits of a real for Writer.
+//
+// A number is scanned once: the grammar is checked and its digits and
+// exponent accumulated on the way, so converting it needs no second pass.
+// Reals are converted by the Clinger fast path when exact, or else by the
+// Eisel-Lemire algorithm, both correctly rounded. The rare numbers neither
+// can decide, and those with more digits than the mantissa holds, are
+// converted in exact decimal arithmetic from all their digits, so no
+// conversion depends on the locale.
+
+#include <cstdint>
+
+#include "simplejson/Reader.h"
+#include "simplejson/Value.h"
+
+namespace SimpleJson::Number {
+
+// an UInteger is a nonnegative integer above the Integer range
+enum class Type { Nan, Integer, UInteger, Real };
+
+/// a number as scanned from the text
+struct Scanned {
+    Type type = Type::Nan;
+    // the char past the number
+    const char* end = nullptr;
+    bool negative = false;
+    // the digits as an integer, scaled by a power of ten for a real
+    uint64_t mantissa = 0;
+    int32_t exponent = 0;
+    // digits beyond the range of `mantissa` were dropped, so an integer
+    // overflows and a real takes the slow path
+    bool truncated = false;
+};
+
+/// number = [ "-" ] int [ frac ] [ exp ]
+Scanned scan(const char* str);
+
+/// an Integer, or NumberOverflow
+ParseResult toInteger(const Scanned& number, Integer& value);
+
+/// an UInteger, or NumberOverflow
+ParseResult toUInteger(const Scanned& number, UInteger& value);
+
+/// a Real of the number at `str`, or NumberOverflow
+ParseResult toReal(const char* str, const Scanned& number, Real& value);
+
+// the slow path alone, exposed for tests and benchmarks
+ParseResult toRealDecimal(const char* str, const Scanned& number,
+                          Real& value);
+
+/// the fewest significant digits that convert back to finite, positive
+/// `number`, into `digits` with room for 17, and the place of the decimal
+/// point, as in 0.d1d2d3... * 10^point; return their count
+/// @note formats without std::to_chars, and so without the locale
+size_t toShortest(Real number, char* digits, int32_t& point);
+
+/// past the integral reals that toIntegral takes, as no fixed form of a
+/// larger one is shorter than its exponent form
+constexpr Real INTEGRAL_MAX = 1e22;
+
+/// all the digits of integral, positive `number` below INTEGRAL_MAX, into
+/// `digits` with room for 22; return their count
+size_t toIntegral(Real number, char* digits);
+
+}  // namespace SimpleJson::Number
+
+#endif  // SIMPLEJSON_NUMBER_H
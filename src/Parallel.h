@@ -0,0 +1,74 @@
+#ifndef SIMPLEJSON_PARALLEL_H
+#define SIMPLEJSON_PARALLEL_H
+
+// Internal fork-join helper for the parallel modes: each call starts its
+// worker threads and joins them before it returns, no thread outlives it.
+//
+// Tasks are taken in turn from a shared counter, so uneven ones balance
+// out; each writes only its own results, and joining the workers publishes
+// them to the caller.
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace SimpleJson {
+
+/// run `task(i)` for each i in [0, count) on up to `threadCount` threads,
+/// this one included, and wait for all of them
+/// @throw the first exception of a task, or of starting a thread, after
+///        the tasks not yet begun are dropped and all threads are joined
+template <typename Task>
+void forEachParallel(const size_t count, const unsigned threadCount,
+                     const Task& task) {
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    const auto fail = [&]() {
+        next = count;
+        if (!failed.exchange(true)) {
+            error = std::current_exception();
+        }
+    };
+    const auto work = [&]() {
+        try {
+            for (auto i = next++; i < count; i = next++) {
+                task(i);
+            }
+        } catch (...) {
+            fail();
+        }
+    };
+
+    {
+        // joins the workers however this scope is left
+        struct Joiner {
+            std::vector<std::thread> workers;
+            ~Joiner() {
+                for (auto& worker : workers) {
+                    worker.join();
+                }
+            }
+        } joiner;
+        try {
+            const auto workerCount = std::min<size_t>(threadCount, count);
+            joiner.workers.reserve(workerCount);
+            for (size_t i = 1; i < workerCount; ++i) {
+                joiner.workers.emplace_back(work);
+            }
+        } catch (...) {
+            fail();
+        }
+        work();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+}  // namespace SimpleJson
+
+#endif  // SIMPLEJSON_PARALLEL_H
@@ -0,0 +1,357 @@
+#include "simplejson/PushParser.h"
+
+#include <cassert>
+#include <optional>
+
+#include "Simd.h"
+#include "ValueBuilder.h"
+
+// helpers
+namespace {
+
+/// whether `c` ends a number or literal: whitespace, or a char that may
+/// follow a value; any other char is kept, and fails as it would in place
+bool endsBare(char c);
+
+}  // namespace
+
+namespace SimpleJson {
+
+// builds the value, starting over after an error
+class PushParser::ValueSink final : public Sink {
+public:
+    ValueSink(Value& root, Value::MemoryResource* const resource)
+        : _root(root), _resource(resource) {
+        _builder.emplace(_root, _resource, nullptr, false);
+    }
+    void onNull() override { _builder->onNull(); }
+    void onBool(const Bool val) override { _builder->onBool(val); }
+    void onInteger(const Integer val) override { _builder->onInteger(val); }
+    void onUInteger(const UInteger val) override {
+        _builder->onUInteger(val);
+    }
+    void onReal(const Real val) override { _builder->onReal(val); }
+    void onString(const std::string_view str) override {
+        _builder->onString(str);
+    }
+    void onStartArray() override { _builder->onStartArray(); }
+    void onEndArray(const size_t size) override { _builder->onEndArray(size); }
+    void onStartObject() override { _builder->onStartObject(); }
+    void onKey(const std::string_view key) override { _builder->onKey(key); }
+    void onEndObject(const size_t size) override {
+        _builder->onEndObject(size);
+    }
+    void fail() override {
+        _root = Value();
+        _builder.emplace(_root, _resource, nullptr, false);
+    }
+
+private:
+    Value& _root;
+    Value::MemoryResource* const _resource;
+    std::optional<ValueBuilder> _builder;
+};
+
+// forwards the events of a string, number or literal, a string as a key
+struct PushParser::TokenSink : BaseHandler {
+    void onNull() { sink.onNull(); }
+    void onBool(const Bool val) { sink.onBool(val); }
+    void onInteger(const Integer val) { sink.onInteger(val); }
+    void onUInteger(const UInteger val) { sink.onUInteger(val); }
+    void onReal(const Real val) { sink.onReal(val); }
+    void onString(const std::string_view str) {
+        key ? sink.onKey(str) : sink.onString(str);
+    }
+
+    Sink& sink;
+    bool key;
+};
+
+PushParser::PushParser(Value& root, Value::MemoryResource* const resource)
+    : _sink(std::make_unique<ValueSink>(root, resource)) {}
+
+bool PushParser::feed(const std::string_view chunk) {
+    if (_finished) {
+        // another document
+        _finished = false;
+        _result = ParseResult::Ok;
+    }
+
+    auto p = chunk.data();
+    const auto pEnd = p + chunk.size();
+    while (p != pEnd && good()) {
+        switch (_state) {
+            case State::String:
+                p = scanString(p, pEnd);
+                break;
+            case State::Bare:
+                p = scanBare(p, pEnd);
+                break;
+            default:
+                p = parseStructure(p, pEnd);
+                break;
+        }
+    }
+    return good();
+}
+
+bool PushParser::finish() {
+    if (_finished) {
+        // another document, an empty one
+        _result = ParseResult::Ok;
+    }
+
+    // a string or number held back ends with the document
+    if (good() && (_state == State::String || _state == State::Bare)) {
+        parseToken();
+    }
+    if (good()) {
+        endDocument();
+    }
+
+    // ready for another document, the result is kept until it starts
+    _state = State::Value;
+    _open.clear();
+    _token.clear();
+    _escaped = false;
+    _finished = true;
+    return good();
+}
+
+/// ws, then the next char between values, or the first one of a value
+const char* PushParser::parseStructure(const char* p,
+                                       const char* const pEnd) {
+    // ws = *(%x20 / %x09 / %x0A / %x0D)
+    while (p != pEnd && Simd::isWhitespace(*p)) {
+        ++p;
+    }
+    if (p == pEnd) {
+        return p;
+    }
+
+    const char c = *p++;
+    switch (_state) {
+        case State::FirstElement:
+            if (c == ']') {
+                close();
+                break;
+            }
+            startValue(c);
+            break;
+        case State::Value:
+            startValue(c);
+            break;
+        case State::FirstMember:
+            if (c == '}') {
+                close();
+                break;
+            }
+            [[fallthrough]];
+        case State::Key:
+            if (c != '"') {
+                error(ParseResult::MissKey);
+                break;
+            }
+            startString(true);
+            break;
+        case State::Colon:
+            if (c != ':') {
+                error(ParseResult::MissColon);
+                break;
+            }
+            _state = State::Value;
+            break;
+        case State::Next:
+            if (_open.empty()) {
+                error(ParseResult::RootNotSingular);
+            } else if (c == ',') {
+                _state = _open.back().object ? State::Key : State::Value;
+            } else if (c == (_open.back().object ? '}' : ']')) {
+                close();
+            } else {
+                error(ParseResult::MissComma);
+            }
+            break;
+        default:
+            // strings and numbers are scanned instead
+            assert(false);
+            break;
+    }
+    return p;
+}
+
+/// the chars of a string up to its closing quotation mark, left unchecked
+/// but for control chars, which fail the string right away
+const char* PushParser::scanString(const char* p, const char* const pEnd) {
+    const auto pBegin = p;
+    if (_escaped) {
+        // the escaped char of the last chunk
+        _escaped = false;
+        ++p;
+    }
+    while (true) {
+        p = Simd::findEscape(p, pEnd);
+        if (p == pEnd) {
+            _token.append(pBegin, p);
+            return p;
+        }
+        const char c = *p++;
+        if (c == '"' || static_cast<unsigned char>(c) < 0x20) {
+            // complete, or failing at the control char
+            _token.append(pBegin, p);
+            parseToken();
+            return p;
+        }
+        if (c == '\\') {
+            if (p == pEnd) {
+                _escaped = true;
+                continue;
+            }
+            ++p;
+        }
+    }
+}
+
+/// the chars of a number or literal up to the next value or whitespace
+const char* PushParser::scanBare(const char* p, const char* const pEnd) {
+    const auto pBegin = p;
+    while (p != pEnd && !endsBare(*p)) {
+        ++p;
+    }
+    _token.append(pBegin, p);
+    if (p != pEnd) {
+        // the char ending it is parsed next
+        parseToken();
+    }
+    return p;
+}
+
+/// value = null / true / false / number / string / array / object
+void PushParser::startValue(const char c) {
+    if ((c == '[' || c == '{') && _open.size() == _reader.maxDepth()) {
+        error(ParseResult::DepthExceeded);
+        return;
+    }
+    switch (c) {
+        case '\0':
+            error(ParseResult::InvalidValue);
+            break;
+        case '"':
+            startString(false);
+            break;
+        case '[':
+            _sink->onStartArray();
+            _open.push_back({false, 0});
+            _state = State::FirstElement;
+            break;
+        case '{':
+            _sink->onStartObject();
+            _open.push_back({true, 0});
+            _state = State::FirstMember;
+            break;
+        default:
+            // a number or literal, or a char failing as one
+            _token.assign(1, c);
+            _state = State::Bare;
+            break;
+    }
+}
+
+void PushParser::startString(const bool key) {
+    _token.assign(1, '"');
+    _key = key;
+    _escaped = false;
+    _state = State::String;
+}
+
+/// parse the string, number or literal scanned, as Reader would in place
+void PushParser::parseToken() {
+    TokenSink sink{{}, *_sink, _key};
+    const auto pBegin = _token.data();
+    const auto pEnd = pBegin + _token.size();
+    const auto p = _reader.parsePrefix(pBegin, pEnd, sink);
+    if (p == nullptr) {
+        error(_reader.result());
+        return;
+    }
+    if (p != pEnd) {
+        // chars right after a number or literal
+        error(_open.empty() ? ParseResult::RootNotSingular
+                            : ParseResult::MissComma);
+        return;
+    }
+
+    if (_key) {
+        _key = false;
+        _state = State::Colon;
+    } else {
+        endValue();
+    }
+}
+
+void PushParser::endValue() {
+    if (!_open.empty()) {
+        ++_open.back().size;
+    }
+    _state = State::Next;
+}
+
+void PushParser::close() {
+    const auto frame = _open.back();
+    _open.pop_back();
+    if (frame.object) {
+        _sink->onEndObject(frame.size);
+    } else {
+        _sink->onEndArray(frame.size);
+    }
+    endValue();
+}
+
+/// the end of document where the next char is expected
+void PushParser::endDocument() {
+    switch (_state) {
+        case State::Value:
+            error(ParseResult::ExpectValue);
+            break;
+        case State::FirstElement:
+            error(ParseResult::MissSquareBracket);
+            break;
+        case State::FirstMember:
+            error(ParseResult::MissCurlyBracket);
+            break;
+        case State::Key:
+            error(ParseResult::MissKey);
+            break;
+        case State::Colon:
+            error(ParseResult::MissColon);
+            break;
+        case State::Next:
+            if (!_open.empty()) {
+                error(_open.back().object ? ParseResult::MissCurlyBracket
+                                          : ParseResult::MissSquareBracket);
+            }
+            break;
+        default:
+            // strings and numbers are parsed before
+            assert(false);
+            break;
+    }
+}
+
+void PushParser::error(const ParseResult errorType) {
+    assert(errorType != ParseResult::Ok);
+    _result = errorType;
+    _sink->fail();
+}
+
+}  // namespace SimpleJson
+
+// ===== helpers =====
+namespace {
+
+bool endsBare(const char c) {
+    return SimpleJson::Simd::isWhitespace(c) || c == ',' || c == ']' ||
+           c == '}';
+}
+
+}  // namespace
@@ -1,94 +1,508 @@
 #include "simplejson/Reader.h"
 
 #include <cassert>
-#include <cerrno>
-#include <cmath>
-#include <cstdlib>
-
-enum class NumberType { Nan, Integer, Real };
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "MappedFile.h"
+#include "Number.h"
+#include "Parallel.h"
+#include "Simd.h"
+#include "Skip.h"
+#include "ValueBuilder.h"
 
 // helpers
 namespace {
 
-/// check what type of number is `str`, and set `end` to the char past it
-NumberType validateNumber(const char* str, const char*& end);
+using SimpleJson::ParseResult;
 
 /// parse str as length-digit hex, return -1 if str is invalid
 int parseHex(const char* str, size_t length);
 
+/// whether a scalar may end at `p`: at whitespace, a structural char or the
+/// end of document
+bool endsScalar(const char* p, const char* pEnd);
+
+/// find the elements of the root array opened at `positions[0]`, from the
+/// `count` structural chars of the document at `pBegin`: the start of each
+/// one, the comma or bracket that ends it, and the bracket closing the root
+/// @return false if they are not in place, e.g. a comma is missing
+bool findElements(const char* pBegin, const uint32_t* positions,
+                  size_t count, std::vector<uint32_t>& starts,
+                  std::vector<uint32_t>& ends, uint32_t& close);
+
+/// a reference token of the pointers projected, with those following it
+struct PathNode {
+    static constexpr size_t NOT_INDEX = SIZE_MAX;
+
+    std::string token;
+    // Index of the element it names, if an array index
+    size_t index = NOT_INDEX;
+    // Whether a pointer ends here, its whole value requested
+    bool whole = false;
+    std::vector<PathNode> children;
+};
+
+/// add the tokens of `pointer` below `root`
+/// @throw std::invalid_argument if it is malformed
+void addPointer(PathNode& root, std::string_view pointer);
+
+/// walks a document along the paths of a tree of PathNode, parsing the
+/// values requested and skipping the others
+class Projector {
+public:
+    Projector(SimpleJson::Reader& reader, const char* pEnd,
+              SimpleJson::Value::MemoryResource* resource,
+              SimpleJson::KeyTable* keyTable)
+        : _reader(reader),
+          _pEnd(pEnd),
+          _resource(resource),
+          _keyTable(keyTable) {}
+
+    /// the value at `p` projected by `node` into `target`, setting `found`
+    /// if any of it is; return the char past it, or null on error
+    const char* project(const char* p, const PathNode& node,
+                        SimpleJson::Value& target, bool& found);
+    [[nodiscard]] SimpleJson::ParseResult result() const { return _result; }
+
+private:
+    const char* projectObject(const char* p, const PathNode& node,
+                              SimpleJson::Value& target, bool& found);
+    const char* projectArray(const char* p, const PathNode& node,
+                             SimpleJson::Value& target, bool& found);
+    const char* fail(SimpleJson::ParseResult errorType);
+
+    SimpleJson::Reader& _reader;
+    // End of document, followed by a NUL
+    const char* const _pEnd;
+    SimpleJson::Value::MemoryResource* const _resource;
+    SimpleJson::KeyTable* const _keyTable;
+    SimpleJson::ParseResult _result = SimpleJson::ParseResult::Ok;
+};
+
 }  // namespace
 
 namespace SimpleJson {
 
-/// JSON = ws value ws
 bool Reader::parse(const char* const pDocument, Value& root) {
-    if (pDocument == nullptr || *pDocument == 0) {
-        root = error(ParseResult::ExpectValue);
+    if (pDocument == nullptr) {
+        error(ParseResult::ExpectValue);
+        root = Value();
+        return false;
+    }
+    return parseTree(pDocument, pDocument + std::strlen(pDocument), root);
+}
+
+bool Reader::parse(const char* const pDocument, const size_t length,
+                   Value& root) {
+    if (pDocument == nullptr) {
+        error(ParseResult::ExpectValue);
+        root = Value();
+        return false;
+    }
+
+    return parseTree(pDocument, pDocument + length, root, false);
+}
+
+bool Reader::parse(char* const pBuffer, const size_t length,
+                   const size_t capacity, Value& root) {
+    if (pBuffer == nullptr || capacity <= length) {
+        return parse(static_cast<const char*>(pBuffer), length, root);
+    }
+
+    // terminate the document in the room past it, and parse it in place
+    pBuffer[length] = 0;
+    return parseTree(pBuffer, pBuffer + length, root);
+}
+
+bool Reader::parse(const std::string& document, Value& root) {
+    // std::string is always NUL-terminated, parse it in place
+    return parseTree(document.data(), document.data() + document.size(),
+                     root);
+}
+
+bool Reader::parseFile(const std::string& path, Value& root) {
+    const MappedFile file(path.c_str());
+    if (!file.good()) {
+        error(ParseResult::InvalidFile);
+        root = Value();
+        return false;
+    }
+
+    // the file is followed by a NUL, parse it in place
+    return parseTree(file.data(), file.data() + file.size(), root);
+}
+
+bool Reader::parseInsitu(char* const pDocument, Value& root) {
+    if (pDocument == nullptr) {
+        error(ParseResult::ExpectValue);
+        root = Value();
+        return false;
+    }
+
+    _insitu = true;
+    const bool res =
+        parseTree(pDocument, pDocument + std::strlen(pDocument), root);
+    _insitu = false;
+    return res;
+}
+
+bool Reader::parseInsitu(std::string& document, Value& root) {
+    _insitu = true;
+    const bool res = parseTree(
+        document.data(), document.data() + document.size(), root);
+    _insitu = false;
+    return res;
+}
+
+bool Reader::parseIndexed(const std::string& document, Value& root) {
+    const auto* const pBegin = document.data();
+    const auto* const pEnd = pBegin + document.size();
+    // positions are 32-bit, and the end of document is one too
+    if (document.size() >= std::numeric_limits<uint32_t>::max()) {
+        return parseTree(pBegin, pEnd, root);
+    }
+
+    // stage 1: all structural chars, a position per char at most
+    if (_index.size() <= document.size()) {
+        _index.resize(document.size() + 1);
+    }
+    size_t count = 0;
+    if (Simd::indexStructurals(pBegin, document.size(), _index.data(),
+                               count)) {
+        _index[count] = static_cast<uint32_t>(document.size());
+        // stage 2: the values at those positions
+        ValueBuilder builder(root, _resource, _keyTable, _insitu);
+        if (parseIndex(pBegin, pEnd, builder)) {
+            return true;
+        }
+        builder.clearOpen();
+    }
+    // stage 2 stops at the first token out of place, which is not always
+    // where the grammar fails first, so parse again for the exact result
+    return parseTree(pBegin, pEnd, root);
+}
+
+bool Reader::parseParallel(const std::string& document, Value& root,
+                           const unsigned threadCount) {
+    const auto* const pBegin = document.data();
+    const auto* const pEnd = pBegin + document.size();
+    // interned keys are not shared between threads, nor is any resource
+    // but the default one known to be thread-safe, positions are 32-bit as
+    // in parseIndexed, and the root array must be allowed
+    if (threadCount <= 1 || _keyTable != nullptr ||
+        _resource != std::pmr::get_default_resource() || _maxDepth == 0 ||
+        document.size() >= std::numeric_limits<uint32_t>::max() ||
+        *Simd::skipWhitespace(pBegin) != '[') {
+        return parseTree(pBegin, pEnd, root);
+    }
+
+    // the elements of the root, from its structural chars
+    if (_index.size() <= document.size()) {
+        _index.resize(document.size() + 1);
+    }
+    size_t count = 0;
+    std::vector<uint32_t> starts;
+    std::vector<uint32_t> ends;
+    uint32_t close = 0;
+    if (!Simd::indexStructurals(pBegin, document.size(), _index.data(),
+                                count) ||
+        !findElements(pBegin, _index.data(), count, starts, ends, close) ||
+        Simd::skipWhitespace(pBegin + close + 1) != pEnd) {
+        return parseTree(pBegin, pEnd, root);
+    }
+
+    // batches of elements of about the same size, a few per thread to
+    // balance them, each element parsed in its place in the root
+    const auto elementCount = starts.size();
+    const auto batchCount = std::min<size_t>(elementCount, threadCount * 4);
+    std::vector<size_t> firsts(batchCount + 1, elementCount);
+    for (size_t i = 0; i < batchCount; ++i) {
+        const auto pos = starts[0] + (close - starts[0]) * i / batchCount;
+        firsts[i] = static_cast<size_t>(
+            std::lower_bound(starts.begin(), starts.end(), pos) -
+            starts.begin());
+    }
+    root = Value(ValueType::Array, _resource);
+    root.resize(elementCount);
+    std::atomic<bool> failed{false};
+    forEachParallel(batchCount, threadCount, [&](const size_t i) {
+        // elements are nested in the root
+        Reader reader(_resource);
+        reader.setMaxDepth(_maxDepth - 1);
+        for (auto k = firsts[i]; k < firsts[i + 1] && !failed; ++k) {
+            ValueBuilder builder(root[k], _resource, nullptr, false);
+            const auto p = reader.parsePrefix(pBegin + starts[k], pEnd,
+                                              builder);
+            if (p == nullptr || Simd::skipWhitespace(p) != pBegin + ends[k]) {
+                builder.clearOpen();
+                failed = true;
+            }
+        }
+    });
+    if (failed) {
+        // parse again for the exact result
+        return parseTree(pBegin, pEnd, root);
+    }
+    _result = ParseResult::Ok;
+    return true;
+}
+
+bool Reader::parseProjected(const std::string& document,
+                            const std::vector<std::string_view>& pointers,
+                            Value& root) {
+    PathNode paths;
+    for (const auto pointer : pointers) {
+        addPointer(paths, pointer);
+    }
+
+    root = Value();
+    const auto* const pEnd = document.data() + document.size();
+    const auto* p = Simd::skipWhitespace(document.data());
+    if (p == pEnd) {
+        error(ParseResult::ExpectValue);
+        return false;
+    }
+    Projector projector(*this, pEnd, _resource, _keyTable);
+    bool found = false;
+    p = projector.project(p, paths, root, found);
+    if (p == nullptr) {
+        root = Value();
+        error(projector.result());
+        return false;
+    }
+    if (Simd::skipWhitespace(p) != pEnd) {
+        root = Value();
+        error(ParseResult::RootNotSingular);
         return false;
     }
+    _result = ParseResult::Ok;
+    return true;
+}
+
+bool Reader::parseTree(const char* const pBegin, const char* const pEnd,
+                       Value& root, const bool terminated) {
+    ValueBuilder builder(root, _resource, _keyTable, _insitu);
+    if (!parseBuffer(pBegin, pEnd, builder, terminated)) {
+        builder.clearOpen();
+        root = Value();
+        return false;
+    }
+    return true;
+}
+
+/// JSON = ws value ws, from the positions in `_index`
+template <typename Handler>
+bool Reader::parseIndex(const char* const pBegin, const char* const pEnd,
+                        Handler& handler) {
+    assert(pBegin != nullptr && pBegin <= pEnd);
+    assert(*pEnd == 0);
 
     // set context
-    _pCur = pDocument;
+    _pBegin = pBegin;
+    _pEnd = pEnd;
+    _pToken = _index.data();
     _result = ParseResult::Ok;
 
-    // parsing
-    skipWhitespace();
-    root = parseValue();
-    if (good()) {
-        skipWhitespace();
-        if (*_pCur != 0) {
-            root = error(ParseResult::RootNotSingular);
-        }
+    // parsing, the end of document is the last position
+    parseIndexedValue(handler);
+    if (good() && nextToken() != _pEnd) {
+        error(ParseResult::RootNotSingular);
     }
 
     _pCur = nullptr;
+    _pBegin = nullptr;
+    _pEnd = nullptr;
+    _pToken = nullptr;
     return good();
 }
 
+/// value = null / true / false / number / string / array / object
+/// arrays and objects are parsed in this loop, on `_stack`, as by parseValue
+template <typename Handler>
+void Reader::parseIndexedValue(Handler& handler) {
+    _stack.clear();
+    do {
+        _pCur = nextToken();
+        const char c = *_pCur;
+        if (c == '[' || c == '{') {
+            // begin of array or object, its elements or members follow
+            if (_stack.size() == _maxDepth) {
+                error(ParseResult::DepthExceeded);
+                return;
+            }
+            const bool object = c == '{';
+            if (object) {
+                handler.onStartObject();
+            } else {
+                handler.onStartArray();
+            }
+            _stack.push_back({object, 0});
+        } else {
+            // a scalar by the grammar, then the next position is the first
+            // char that is not whitespace, unless more of the scalar follows
+            parseScalar(handler);
+            if (good() && !endsScalar(_pCur, _pEnd)) {
+                error(ParseResult::InvalidValue);
+            }
+            if (!good()) {
+                return;
+            }
+            if (_stack.empty()) {
+                return;
+            }
+            ++_stack.back().size;
+        }
+    } while (parseIndexedNext(handler));
+}
+
+/// array = %x5B ws [ value *( ws %x2C ws value ) ] ws %x5D
+/// object = %x7B ws [ member *( ws %x2C ws member ) ] ws %x7D
+/// member = string ws %x3A ws value
+/// as parseNext, from the positions in `_index`, up to that of the next
+/// value; return whether one follows
+template <typename Handler>
+bool Reader::parseIndexedNext(Handler& handler) {
+    while (!_stack.empty()) {
+        const auto frame = _stack.back();
+        const auto* const p = peekToken();
+        if (*p == (frame.object ? '}' : ']')) {
+            // end of array or object, a value of its parent
+            ++_pToken;
+            _stack.pop_back();
+            if (frame.object) {
+                handler.onEndObject(frame.size);
+            } else {
+                handler.onEndArray(frame.size);
+            }
+            if (!_stack.empty()) {
+                ++_stack.back().size;
+            }
+            continue;
+        }
+        if (frame.size != 0) {
+            // expect comma
+            if (*p != ',') {
+                error(p != _pEnd       ? ParseResult::MissComma
+                      : frame.object ? ParseResult::MissCurlyBracket
+                                     : ParseResult::MissSquareBracket);
+                return false;
+            }
+            ++_pToken;
+        }
+        if (!frame.object) {
+            // parse element
+            return true;
+        }
+
+        // parse key
+        _pCur = nextToken();
+        if (*_pCur != '"') {
+            error(_pCur == _pEnd ? ParseResult::MissCurlyBracket
+                                 : ParseResult::MissKey);
+            return false;
+        }
+        std::string_view key;
+        if (auto res = parseString(key); res != ParseResult::Ok) {
+            error(res);
+            return false;
+        }
+        handler.onKey(key);
+
+        // ':', the first char past the key that is not whitespace
+        if (*nextToken() != ':') {
+            error(ParseResult::MissColon);
+            return false;
+        }
+
+        // parse value
+        return true;
+    }
+    // the root is complete
+    return false;
+}
+
 /// ws = *(%x20 / %x09 / %x0A / %x0D)
 void Reader::skipWhitespace() {
     assert(_pCur != nullptr);
+    if (_pCur >= _pLimit) {
+        copyTail();
+    }
+    // minified documents have no whitespace between tokens, and pretty ones
+    // mostly a single space, so only indentation goes to the vector kernel
     auto p = _pCur;
-    while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') {
+    if (Simd::isWhitespace(*p)) {
         ++p;
+        if (Simd::isWhitespace(*p)) {
+            p = Simd::skipWhitespace(p);
+        }
     }
     _pCur = p;
 }
 
-Value Reader::error(const ParseResult errorType) {
+/// the start of the whitespace, number or literal ending [pBegin, pEnd):
+/// scans for those stop at any other char, so only one starting in this
+/// tail could run past the end; strings are scanned up to `_pEnd`
+const char* Reader::findTail(const char* const pBegin, const char* pEnd) {
+    const auto inTail = [](const char c) {
+        return Simd::isWhitespace(c) || (c >= '0' && c <= '9') || c == '+' ||
+               c == '-' || c == '.' || (c >= 'a' && c <= 'z') ||
+               (c >= 'A' && c <= 'Z');
+    };
+    while (pEnd != pBegin && inTail(pEnd[-1])) {
+        --pEnd;
+    }
+    return pEnd;
+}
+
+/// parse the rest of the document from a terminated copy, every token
+/// starting past `_pLimit` after whitespace is skipped
+void Reader::copyTail() {
+    _docBuf.assign(_pCur, _pEnd);
+    _pCur = _docBuf.data();
+    _pEnd = _pCur + _docBuf.size();
+    _pLimit = _pEnd + 1;
+}
+
+void Reader::error(const ParseResult errorType) {
     assert(errorType != ParseResult::Ok);
     _result = errorType;
-    return Value();
 }
 
-/// value = null / true / false / number / string
-Value Reader::parseValue() {
-    assert(_pCur != nullptr);
+/// a string value, placed in situ if parsing so
+bool Reader::parseStringValue(std::string_view& str) {
+    const auto pSource = _pCur + 1;
+    if (auto res = parseString(str); res != ParseResult::Ok) {
+        error(res);
+        return false;
+    }
+    if (_insitu) {
+        str = placeInsitu(str, pSource);
+    }
+    return true;
+}
 
-    switch (*_pCur) {
-        case '\0':
-            return error(ParseResult::ExpectValue);
-        case 'n':
-            return parseLiteral("null", Value());
-        case 't':
-            return parseLiteral("true", true);
-        case 'f':
-            return parseLiteral("false", false);
-        case '"':
-            if (auto res = parseString(); res != ParseResult::Ok) {
-                return error(res);
-            }
-            return Value(_strBuf);
-        case '[':
-            return parseArray();
-        case '{':
-            return parseObject();
-        default:
-            return parseNumber();
+/// put unescaped `str` over its source text at `pSource` and terminate it
+std::string_view Reader::placeInsitu(const std::string_view str,
+                                     const char* const pSource) {
+    assert(_insitu);
+    assert(pSource + str.size() < _pCur);
+
+    // the document is mutable when parsing in situ
+    auto* const p = const_cast<char*>(pSource);
+    if (str.data() != pSource) {
+        // unescaping never makes a string longer
+        str.copy(p, str.size());
     }
+    p[str.size()] = 0;
+    return std::string_view(p, str.size());
 }
 
-Value Reader::parseLiteral(std::string_view literal, Value value) {
+bool Reader::parseLiteral(std::string_view literal) {
     assert(_pCur != nullptr);
     assert(!literal.empty());
     assert(*_pCur == literal[0]);
@@ -96,91 +510,53 @@ Value Reader::parseLiteral(std::string_view literal, Value value) {
     auto p = _pCur;
     for (const char c : literal) {
         if (*p != c) {
-            return error(ParseResult::InvalidValue);
+            error(ParseResult::InvalidValue);
+            return false;
         }
         ++p;
     }
     _pCur = p;
-    return value;
-}
-
-/// number = [ "-" ] int [ frac ] [ exp ]
-Value Reader::parseNumber() {
-    assert(_pCur != nullptr);
-    assert(*_pCur != 0);
-
-    const char* numberEnd = nullptr;
-    const auto numberType = validateNumber(_pCur, numberEnd);
-    assert(numberEnd >= _pCur);
-
-    switch (numberType) {
-        case NumberType::Nan:
-            return error(ParseResult::InvalidValue);
-        case NumberType::Integer:
-            return parseInteger(numberEnd);
-        case NumberType::Real:
-            return parseReal(numberEnd);
-    }
-
-    // not possible
-    return error(ParseResult::InvalidValue);
-}
-
-Value Reader::parseInteger(const char* const numberEnd) {
-    assert(_pCur != nullptr);
-    assert(*_pCur != 0);
-    assert(_pCur < numberEnd);
-
-    // parse
-    char* actualEnd;
-    errno = 0;
-    const Integer value = std::strtoll(_pCur, &actualEnd, 10);
-
-    assert(actualEnd > _pCur);
-    if (actualEnd <= _pCur) {
-        // not possible
-        return error(ParseResult::InvalidValue);
-    }
-
-    // overflow
-    if (errno == ERANGE) {
-        return error(ParseResult::NumberOverflow);
-    }
-
-    // success
-    _pCur = numberEnd;
-    return Value(value);
+    return true;
 }
 
-Value Reader::parseReal(const char* const numberEnd) {
+/// scan and convert a number into `number`
+bool Reader::scanNumber(ScannedNumber& number) {
     assert(_pCur != nullptr);
     assert(*_pCur != 0);
-    assert(_pCur < numberEnd);
-
-    // parse
-    char* actualEnd;
-    errno = 0;
-    const Real value = std::strtod(_pCur, &actualEnd);
 
-    assert(actualEnd > _pCur);
-    if (actualEnd <= _pCur) {
-        // not possible
-        return error(ParseResult::InvalidValue);
+    const auto scanned = Number::scan(_pCur);
+    ParseResult res = ParseResult::Ok;
+    switch (scanned.type) {
+        case Number::Type::Nan:
+            error(ParseResult::InvalidValue);
+            return false;
+        case Number::Type::Integer:
+            number.type = ValueType::Integer;
+            res = Number::toInteger(scanned, number.integer);
+            break;
+        case Number::Type::UInteger:
+            number.type = ValueType::UInteger;
+            res = Number::toUInteger(scanned, number.uinteger);
+            break;
+        case Number::Type::Real:
+            number.type = ValueType::Real;
+            res = Number::toReal(_pCur, scanned, number.real);
+            break;
     }
-
-    // overflow
-    if (errno == ERANGE && (value == HUGE_VAL || value == -HUGE_VAL)) {
-        return error(ParseResult::NumberOverflow);
+    if (res != ParseResult::Ok) {
+        error(res);
+        return false;
     }
 
     // success
-    _pCur = numberEnd;
-    return Value(value);
+    _pCur = scanned.end;
+    return true;
 }
 
 /// string = quotation-mark *char quotation-mark
-/// @note if return Ok, value is in `_strBuf`
-ParseResult Reader::parseString() {
+/// @note if return Ok, `str` refers to the document, or to `_strBuf` if the
+///       string has escapes
+ParseResult Reader::parseString(std::string_view& str) {
     assert(_pCur != nullptr);
     assert(*_pCur == '"');
     // string = quotation-mark *char quotation-mark
@@ -192,35 +568,45 @@ ParseResult Reader::parseString() {
     // quotation-mark
     ++_pCur;
 
-    _strBuf.clear();
+    bool escaped = false;
     while (true) {
-        const char c = *_pCur;
-        if (c == '\0') {
+        // find the end of the run of unescaped chars
+        const auto p = Simd::scanStringUntil(_pCur, _pEnd);
+        if (p == _pEnd) {
             // end of document
+            _pCur = p;
             return ParseResult::MissQuotationMark;
         }
-        if (static_cast<unsigned char>(c) < '\x20') {
-            // invalid char
-            return ParseResult::InvalidStringChar;
-        }
-
-        // c is valid char
+        const char c = *p;
         if (c == '"') {
             // end of string
-            ++_pCur;
+            if (escaped) {
+                _strBuf.append(_pCur, p);
+                str = _strBuf;
+            } else {
+                str = std::string_view(_pCur, p - _pCur);
+            }
+            _pCur = p + 1;
             return ParseResult::Ok;
         }
         if (c == '\\') {
-            // escaped
+            // escaped, copy the run so far in one go
+            if (!escaped) {
+                _strBuf.clear();
+                escaped = true;
+            }
+            _strBuf.append(_pCur, p);
+            _pCur = p;
             const auto res = parseEscaped();
             if (res != ParseResult::Ok) {
                 return res;
             }
-        } else {
-            // unescaped
-            _strBuf.push_back(c);
-            ++_pCur;
+            continue;
         }
+
+        // invalid char
+        _pCur = p;
+        return ParseResult::InvalidStringChar;
     }
     // never goto here
 }
@@ -242,8 +628,9 @@ ParseResult Reader::parseEscaped() {
     //       %x75 4HEXDIG )  ; uXXXX                U+XXXX
     // escape = %x5C         ; \    reverse solidus
 
+    // the document may end right after the reverse solidus
     char c = 0;
-    switch (_pCur[1]) {
+    switch (_pCur + 1 != _pEnd ? _pCur[1] : '\0') {
         case '"':
         case '\\':
         case '/':
@@ -288,12 +675,15 @@ ParseResult Reader::parseUnicode() {
     constexpr auto LOW_SURROGATE_MIN = 0xDC00;
     constexpr auto LOW_SURROGATE_MAX = 0xDFFF;
     constexpr auto SURROGATE_PAIR_MIN = 0x1'0000;
-    constexpr auto SURROGATE_PAIR_MAX = 0x10'FFFF;
+    [[maybe_unused]] constexpr auto SURROGATE_PAIR_MAX = 0x10'FFFF;
 
     auto p = _pCur;
     p += 2;
 
-    // parse code point
+    // parse code point, its digits may run past the end of document
+    if (_pEnd - p < HEX_DIGIT_LEN) {
+        return ParseResult::InvalidUnicodeHex;
+    }
     int codePoint = parseHex(p, HEX_DIGIT_LEN);
     if (codePoint == -1) {
         return ParseResult::InvalidUnicodeHex;
@@ -304,11 +694,14 @@ ParseResult Reader::parseUnicode() {
     // surrogate pair
     if (codePoint >= HIGH_SURROGATE_MIN && codePoint <= HIGH_SURROGATE_MAX) {
         const int high = codePoint;
-        if (p[0] != '\\' || p[1] != 'u') {
+        if (_pEnd - p < 2 || p[0] != '\\' || p[1] != 'u') {
             return ParseResult::InvalidUnicodeSurrogate;
         }
         p += 2;
 
+        if (_pEnd - p < HEX_DIGIT_LEN) {
+            return ParseResult::InvalidUnicodeHex;
+        }
         const int low = parseHex(p, HEX_DIGIT_LEN);
         if (low == -1) {
             return ParseResult::InvalidUnicodeHex;
@@ -338,7 +731,7 @@ void Reader::encodeUnicode(const unsigned codePoint) {
     if (codePoint <= 0x007F) {
         // 7-bit code point, 1-byte code unit
         // 0xx'xxxx
-        _strBuf.push_back(0b11'1111 & codePoint);
+        _strBuf.push_back(0b111'1111 & codePoint);
     } else if (codePoint <= 0x07FF) {
         // 11-bit code point, 2-byte code unit
         // 110x'xxxx 10xx'xxxx
@@ -360,202 +753,306 @@ void Reader::encodeUnicode(const unsigned codePoint) {
     }
 }
 
-/// array = %x5B ws [ value *( ws %x2C ws value ) ] ws %x5D
-Value Reader::parseArray() {
-    assert(_pCur != nullptr);
-    assert(*_pCur == '[');
+}  // namespace SimpleJson
 
-    // '['
-    ++_pCur;
+// ===== helpers =====
+namespace {
 
-    auto array = Value(ValueType::Array);
-    while (true) {
-        skipWhitespace();
-        const char c = *_pCur;
-        if (c == '\0') {
-            // end of document
-            return error(ParseResult::MissSquareBracket);
+int parseHex(const char* str, const size_t length) {
+    assert(str != nullptr);
+    if (str == nullptr) {
+        // not possible
+        return -1;
+    }
+
+    int res = 0;
+    for (size_t i = 0; i < length; ++i) {
+        const char c = str[i];
+
+        int val = 0;
+        if (c >= '0' && c <= '9') {
+            val = c - '0';
+        } else if (c >= 'A' && c <= 'F') {
+            val = c - 'A' + 10;
+        } else if (c >= 'a' && c <= 'f') {
+            val = c - 'a' + 10;
+        } else {
+            return -1;
         }
-        if (c == ']') {
-            // end of array
-            ++_pCur;
-            return array;
+
+        res *= 16;
+        res += val;
+    }
+
+    return res;
+}
+
+bool endsScalar(const char* const p, const char* const pEnd) {
+    switch (*p) {
+        case '{':
+        case '}':
+        case '[':
+        case ']':
+        case ':':
+        case ',':
+            return true;
+        default:
+            return p == pEnd || SimpleJson::Simd::isWhitespace(*p);
+    }
+}
+
+bool findElements(const char* const pBegin, const uint32_t* const positions,
+                  const size_t count, std::vector<uint32_t>& starts,
+                  std::vector<uint32_t>& ends, uint32_t& close) {
+    assert(count > 0 && pBegin[positions[0]] == '[');
+    size_t depth = 1;
+    bool expectElement = true;
+    for (size_t i = 1; i < count; ++i) {
+        const auto pos = positions[i];
+        const char c = pBegin[pos];
+        if (depth == 1) {
+            if (c == ',' || c == ']') {
+                if (c == ',' || !starts.empty()) {
+                    ends.push_back(pos);
+                }
+                if (c == ']') {
+                    close = pos;
+                    return starts.size() == ends.size();
+                }
+                expectElement = true;
+                continue;
+            }
+            if (expectElement) {
+                starts.push_back(pos);
+                expectElement = false;
+            }
         }
-        if (!array.empty()) {
-            // expect comma
-            if (c != ',') {
-                return error(ParseResult::MissComma);
+        if (c == '[' || c == '{') {
+            ++depth;
+        } else if ((c == ']' || c == '}') && --depth == 0) {
+            // a curly bracket closing the root
+            return false;
+        }
+    }
+    // the root is not closed
+    return false;
+}
+
+void addPointer(PathNode& root, std::string_view pointer) {
+    // json-pointer = *( "/" reference-token )
+    if (!pointer.empty() && pointer.front() != '/') {
+        throw std::invalid_argument("invalid JSON Pointer: " +
+                                    std::string(pointer));
+    }
+    auto* node = &root;
+    while (!pointer.empty()) {
+        pointer.remove_prefix(1);
+        const auto length = std::min(pointer.find('/'), pointer.size());
+
+        // "~1" is a solidus and "~0" a tilde
+        std::string token;
+        for (size_t i = 0; i < length; ++i) {
+            if (pointer[i] != '~') {
+                token.push_back(pointer[i]);
+            } else if (i + 1 < length &&
+                       (pointer[i + 1] == '0' || pointer[i + 1] == '1')) {
+                token.push_back(pointer[++i] == '0' ? '~' : '/');
+            } else {
+                throw std::invalid_argument("invalid JSON Pointer: " +
+                                            std::string(pointer));
             }
-            ++_pCur;
-            skipWhitespace();
         }
-        // parse element
-        auto element = parseValue();
-        if (!good()) {
-            return Value();
+        pointer.remove_prefix(length);
+
+        const auto child =
+            std::find_if(node->children.begin(), node->children.end(),
+                         [&](const PathNode& c) { return c.token == token; });
+        if (child != node->children.end()) {
+            node = &*child;
+            continue;
+        }
+        // array-index = %x30 / ( %x31-39 *(%x30-39) ), within size_t
+        auto index = PathNode::NOT_INDEX;
+        if (!token.empty() && token.size() < 19 &&
+            (token == "0" || token.front() != '0') &&
+            std::all_of(token.begin(), token.end(),
+                        [](const char c) { return c >= '0' && c <= '9'; })) {
+            index = std::stoull(token);
         }
-        array.append(std::move(element));
+        node->children.push_back({std::move(token), index, false, {}});
+        node = &node->children.back();
     }
-    // never goto here
+    node->whole = true;
 }
 
-/// object = %x7B ws [ member *( ws %x2C ws member ) ] ws %x7D
-Value Reader::parseObject() {
-    assert(_pCur != nullptr);
-    assert(*_pCur == '{');
+const char* Projector::project(const char* const p, const PathNode& node,
+                               SimpleJson::Value& target, bool& found) {
+    if (node.whole) {
+        SimpleJson::ValueBuilder builder(target, _resource, _keyTable, false);
+        const auto pNext = _reader.parsePrefix(p, _pEnd, builder);
+        if (pNext == nullptr) {
+            builder.clearOpen();
+            return fail(_reader.result());
+        }
+        found = true;
+        return pNext;
+    }
 
-    // '{'
-    ++_pCur;
+    switch (*p) {
+        case '{':
+            return projectObject(p, node, target, found);
+        case '[':
+            return projectArray(p, node, target, found);
+        default: {
+            // nothing within a scalar
+            auto res = ParseResult::Ok;
+            const auto pNext = SimpleJson::skipValue(p, _pEnd, res);
+            return pNext == nullptr ? fail(res) : pNext;
+        }
+    }
+}
 
-    auto object = Value(ValueType::Object);
-    while (true) {
-        skipWhitespace();
-        const char c = *_pCur;
-        if (c == '\0') {
-            // end of document
-            return error(ParseResult::MissCurlyBracket);
+/// object = %x7B ws [ member *( ws %x2C ws member ) ] ws %x7D
+const char* Projector::projectObject(const char* p, const PathNode& node,
+                                     SimpleJson::Value& target,
+                                     bool& found) {
+    using SimpleJson::Simd::skipWhitespace;
+    assert(*p == '{');
+
+    ++p;
+    std::string key;
+    for (bool first = true;; first = false) {
+        p = skipWhitespace(p);
+        if (p == _pEnd) {
+            return fail(ParseResult::MissCurlyBracket);
         }
-        if (c == '}') {
-            // end of object
-            ++_pCur;
-            return object;
+        if (*p == '}') {
+            return p + 1;
         }
-        if (!object.empty()) {
-            // expect comma
-            if (c != ',') {
-                return error(ParseResult::MissComma);
+        if (!first) {
+            if (*p != ',') {
+                return fail(ParseResult::MissComma);
             }
-            ++_pCur;
-            skipWhitespace();
+            p = skipWhitespace(p + 1);
         }
 
         // member = string ws %x3A ws value
-        // parse key
-        if (*_pCur != '"') {
-            return error(ParseResult::MissKey);
+        if (*p != '"') {
+            return fail(ParseResult::MissKey);
+        }
+        if (const auto pQuote = SimpleJson::Simd::scanString(p + 1);
+            *pQuote == '"') {
+            // no escapes, the text is the key
+            key.assign(p + 1, pQuote);
+            p = pQuote + 1;
+        } else {
+            struct KeyCapture : SimpleJson::BaseHandler {
+                void onString(const std::string_view str) { key = str; }
+                std::string& key;
+            } capture{{}, key};
+            p = _reader.parsePrefix(p, _pEnd, capture);
+            if (p == nullptr) {
+                return fail(_reader.result());
+            }
         }
-        if (auto res = parseString(); res != ParseResult::Ok) {
-            return error(res);
+        p = skipWhitespace(p);
+        if (*p != ':') {
+            return fail(ParseResult::MissColon);
         }
-        const auto key = _strBuf;
-
-        // ':'
-        skipWhitespace();
-        if (*_pCur != ':') {
-            return error(ParseResult::MissColon);
+        p = skipWhitespace(p + 1);
+
+        // a member of a key requested, the others are skipped
+        const auto child =
+            std::find_if(node.children.begin(), node.children.end(),
+                         [&](const PathNode& c) { return c.token == key; });
+        if (child == node.children.end()) {
+            auto res = ParseResult::Ok;
+            p = SimpleJson::skipValue(p, _pEnd, res);
+            if (p == nullptr) {
+                return fail(res);
+            }
+            continue;
         }
-        ++_pCur;
-        skipWhitespace();
-
-        // parse value
-        auto value = parseValue();
-        if (!good()) {
-            return Value();
+        SimpleJson::Value value;
+        bool valueFound = false;
+        p = project(p, *child, value, valueFound);
+        if (p == nullptr) {
+            return nullptr;
+        }
+        // a repeated key replaces what the earlier members gave, as the
+        // last one is kept by parse
+        if (valueFound) {
+            if (!found) {
+                target = SimpleJson::Value(SimpleJson::ValueType::Object,
+                                           _resource);
+                found = true;
+            }
+            target[child->token] = std::move(value);
+        } else if (found && target.isMember(child->token)) {
+            (void)target.removeMember(child->token);
+            if (target.empty()) {
+                target = SimpleJson::Value();
+                found = false;
+            }
         }
-        object[key] = std::move(value);
     }
-    // never goto here
 }
 
-}  // namespace SimpleJson
-
-// ===== helpers =====
-namespace {
-
-NumberType validateNumber(const char* const str, const char*& end) {
-    // number = [ "-" ] int [ frac ] [ exp ]
-    assert(str != nullptr);
-    assert(*str != 0);
-    if (str == nullptr) {
-        // not possible
-        return NumberType::Nan;
-    }
-
-    end = str;
-    auto p = str;
-    bool isReal = false;
-
-    // [ "-" ]
-    if (*p == '-') {
-        ++p;
-    }
-
-    // int = "0" / digit1-9 *digit
-    if (*p == '0') {
-        ++p;
-    } else if (*p >= '1' && *p <= '9') {
-        ++p;
-        while (*p >= '0' && *p <= '9') {
-            ++p;
+/// array = %x5B ws [ value *( ws %x2C ws value ) ] ws %x5D
+const char* Projector::projectArray(const char* p, const PathNode& node,
+                                    SimpleJson::Value& target, bool& found) {
+    using SimpleJson::Simd::skipWhitespace;
+    assert(*p == '[');
+
+    ++p;
+    for (size_t i = 0;; ++i) {
+        p = skipWhitespace(p);
+        if (p == _pEnd) {
+            return fail(ParseResult::MissSquareBracket);
         }
-    } else {
-        return NumberType::Nan;
-    }
-
-    // frac = "." 1*digit
-    if (*p == '.') {
-        ++p;
-        isReal = true;
-        if (*p >= '0' && *p <= '9') {
-            ++p;
-            while (*p >= '0' && *p <= '9') {
-                ++p;
+        if (*p == ']') {
+            return p + 1;
+        }
+        if (i != 0) {
+            if (*p != ',') {
+                return fail(ParseResult::MissComma);
             }
-        } else {
-            return NumberType::Nan;
+            p = skipWhitespace(p + 1);
         }
-    }
 
-    // exp = ("e" / "E") ["-" / "+"] 1*digit
-    if (*p == 'e' || *p == 'E') {
-        ++p;
-        isReal = true;
-        if (*p == '-' || *p == '+') {
-            ++p;
-        }
-        if (*p >= '0' && *p <= '9') {
-            ++p;
-            while (*p >= '0' && *p <= '9') {
-                ++p;
+        const auto child = std::find_if(
+            node.children.begin(), node.children.end(),
+            [&](const PathNode& c) { return c.index == i; });
+        if (child == node.children.end()) {
+            auto res = ParseResult::Ok;
+            p = SimpleJson::skipValue(p, _pEnd, res);
+            if (p == nullptr) {
+                return fail(res);
             }
-        } else {
-            return NumberType::Nan;
+            continue;
         }
-    }
-
-    end = p;
-    assert(end >= str);
-
-    return isReal ? NumberType::Real : NumberType::Integer;
-}
-
-int parseHex(const char* str, const size_t length) {
-    assert(str != nullptr);
-    if (str == nullptr) {
-        // not possible
-        return -1;
-    }
-
-    int res = 0;
-    for (size_t i = 0; i < length; ++i) {
-        const char c = str[i];
-
-        int val = 0;
-        if (c >= '0' && c <= '9') {
-            val = c - '0';
-        } else if (c >= 'A' && c <= 'F') {
-            val = c - 'A' + 10;
-        } else if (c >= 'a' && c <= 'f') {
-            val = c - 'a' + 10;
-        } else {
-            return -1;
+        SimpleJson::Value value;
+        bool valueFound = false;
+        p = project(p, *child, value, valueFound);
+        if (p == nullptr) {
+            return nullptr;
+        }
+        if (valueFound) {
+            if (!found) {
+                target = SimpleJson::Value(SimpleJson::ValueType::Array,
+                                           _resource);
+                found = true;
+            }
+            target.resize(i + 1);
+            target[i] = std::move(value);
         }
-
-        res *= 16;
-        res += val;
     }
+}
 
-    return res;
+const char* Projector::fail(const ParseResult errorType) {
+    assert(errorType != ParseResult::Ok);
+    _result = errorType;
+    return nullptr;
 }
 
 }  // namespace
@@ -0,0 +1,836 @@
+#include "Simd.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMPLEJSON_SSE2
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__)
+// AVX2 kernels are compiled per function, the rest keeps the baseline ISA
+#define SIMPLEJSON_TARGET_AVX2 __attribute__((target("avx2")))
+// aligned block loads may touch bytes around the string, see Simd.h
+#define SIMPLEJSON_NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#else
+#define SIMPLEJSON_TARGET_AVX2
+#define SIMPLEJSON_NO_SANITIZE_ADDRESS
+#endif
+
+// helpers
+namespace {
+
+/// chars of each class in a block of 64, a bit per char
+struct BlockMasks {
+    uint64_t backslash = 0;
+    uint64_t quote = 0;
+    uint64_t whitespace = 0;
+    // {}[]:,
+    uint64_t op = 0;
+};
+
+/// finds the structural chars of consecutive blocks of 64, carrying what
+/// a block tells about the start of the next one
+class StructuralScanner {
+public:
+    /// the structural chars of the next block
+    uint64_t next(const BlockMasks& masks);
+    /// whether the last block ended within a string
+    [[nodiscard]] bool inString() const { return _inString != 0; }
+
+private:
+    // the first char of the next block is escaped
+    uint64_t _escaped = 0;
+    // all ones if the next block starts within a string
+    uint64_t _inString = 0;
+    // the last char was part of a literal or a number
+    uint64_t _scalar = 0;
+};
+
+/// classify the 64 chars at `block`
+BlockMasks classifyScalar(const char* block);
+
+/// index the structural chars a block of 64 at a time, see indexStructurals
+template <BlockMasks (*classify)(const char*)>
+bool indexBlocks(const char* str, size_t size, uint32_t* positions,
+                 size_t& count);
+
+/// the index of the lowest set bit, `mask` must not be zero
+int countTrailingZeros64(uint64_t mask);
+
+/// each bit xor-ed with all those below it
+uint64_t prefixXor(uint64_t mask);
+
+/// the 32 bits of a byte mask at bit `shift` of a block mask
+uint64_t placeBits(int mask, unsigned shift);
+
+}  // namespace
+
+#ifdef SIMPLEJSON_SSE2
+
+// helpers
+namespace {
+
+constexpr uintptr_t SSE2_BLOCK = 16;
+constexpr uintptr_t AVX2_BLOCK = 32;
+
+/// the index of the lowest set bit, `mask` must not be zero
+int countTrailingZeros(uint32_t mask);
+
+/// round `str` down to a multiple of `alignment`
+const char* alignDown(const char* str, uintptr_t alignment);
+
+/// classify the 64 chars at `block`
+BlockMasks classifySse2(const char* block);
+SIMPLEJSON_TARGET_AVX2 BlockMasks classifyAvx2(const char* block);
+
+}  // namespace
+
+#endif  // SIMPLEJSON_SSE2
+
+namespace SimpleJson::Simd {
+
+const char* skipWhitespace(const char* const str) {
+    using Kernel = const char* (*)(const char*);
+    static const Kernel kernel = hasAvx2()   ? skipWhitespaceAvx2
+                                 : hasSse2() ? skipWhitespaceSse2
+                                             : skipWhitespaceScalar;
+    return kernel(str);
+}
+
+const char* skipWhitespaceScalar(const char* const str) {
+    assert(str != nullptr);
+    auto p = str;
+    while (isWhitespace(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+const char* scanString(const char* const str) {
+    using Kernel = const char* (*)(const char*);
+    static const Kernel kernel = hasAvx2()   ? scanStringAvx2
+                                 : hasSse2() ? scanStringSse2
+                                             : scanStringSwar;
+    return kernel(str);
+}
+
+SIMPLEJSON_NO_SANITIZE_ADDRESS
+const char* scanStringSwar(const char* const str) {
+    assert(str != nullptr);
+    constexpr uint64_t ONES = 0x0101'0101'0101'0101ULL;
+    constexpr uint64_t HIGHS = 0x8080'8080'8080'8080ULL;
+    constexpr uint64_t QUOTES = ONES * '"';
+    constexpr uint64_t BACKSLASHES = ONES * '\\';
+    constexpr uint64_t SPACES = ONES * ' ';
+    const auto isSpecial = [](const char c) {
+        return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+    };
+
+    // bytewise up to the first aligned word
+    auto p = str;
+    while (reinterpret_cast<uintptr_t>(p) % sizeof(uint64_t) != 0) {
+        if (isSpecial(*p)) {
+            return p;
+        }
+        ++p;
+    }
+
+    // a word at a time, flagging bytes equal to '"' or '\\', or below ' '
+    while (true) {
+        uint64_t word = 0;
+        std::memcpy(&word, p, sizeof(word));
+        const auto quote = word ^ QUOTES;
+        const auto backslash = word ^ BACKSLASHES;
+        const auto flags = ((quote - ONES) & ~quote) |
+                           ((backslash - ONES) & ~backslash) |
+                           ((word - SPACES) & ~word);
+        if ((flags & HIGHS) != 0) {
+            break;
+        }
+        p += sizeof(word);
+    }
+    // the word has a special char, find it bytewise regardless of endianness
+    while (!isSpecial(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+const char* scanStringUntil(const char* const begin, const char* const end) {
+    using Kernel = const char* (*)(const char*, const char*);
+    static const Kernel kernel = hasAvx2()   ? scanStringUntilAvx2
+                                 : hasSse2() ? scanStringUntilSse2
+                                             : scanStringUntilSwar;
+    return kernel(begin, end);
+}
+
+const char* scanStringUntilSwar(const char* const begin,
+                                const char* const end) {
+    assert(begin <= end);
+    constexpr uint64_t ONES = 0x0101'0101'0101'0101ULL;
+    constexpr uint64_t HIGHS = 0x8080'8080'8080'8080ULL;
+    constexpr uint64_t QUOTES = ONES * '"';
+    constexpr uint64_t BACKSLASHES = ONES * '\\';
+    constexpr uint64_t SPACES = ONES * ' ';
+    const auto isSpecial = [](const char c) {
+        return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+    };
+
+    // a word at a time, flagging bytes equal to '"' or '\\', or below ' ',
+    // then bytewise through the flagged word or the remaining bytes
+    auto p = begin;
+    while (end - p >= static_cast<ptrdiff_t>(sizeof(uint64_t))) {
+        uint64_t word = 0;
+        std::memcpy(&word, p, sizeof(word));
+        const auto quote = word ^ QUOTES;
+        const auto backslash = word ^ BACKSLASHES;
+        const auto flags = ((quote - ONES) & ~quote) |
+                           ((backslash - ONES) & ~backslash) |
+                           ((word - SPACES) & ~word);
+        if ((flags & HIGHS) != 0) {
+            break;
+        }
+        p += sizeof(word);
+    }
+    while (p != end && !isSpecial(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+const char* findEscape(const char* const begin, const char* const end) {
+    using Kernel = const char* (*)(const char*, const char*);
+    static const Kernel kernel = hasAvx2()   ? findEscapeAvx2
+                                 : hasSse2() ? findEscapeSse2
+                                             : findEscapeSwar;
+    return kernel(begin, end);
+}
+
+const char* findEscapeSwar(const char* const begin, const char* const end) {
+    assert(begin <= end);
+    constexpr uint64_t ONES = 0x0101'0101'0101'0101ULL;
+    constexpr uint64_t HIGHS = 0x8080'8080'8080'8080ULL;
+    constexpr uint64_t QUOTES = ONES * '"';
+    constexpr uint64_t BACKSLASHES = ONES * '\\';
+    constexpr uint64_t SLASHES = ONES * '/';
+    constexpr uint64_t SPACES = ONES * ' ';
+    const auto isEscaped = [](const char c) {
+        return c == '"' || c == '\\' || c == '/' ||
+               static_cast<unsigned char>(c) < 0x20;
+    };
+
+    // a word at a time, flagging bytes equal to '"', '\\' or '/', or below
+    // ' ', then bytewise through the flagged word or the remaining bytes
+    auto p = begin;
+    while (end - p >= static_cast<ptrdiff_t>(sizeof(uint64_t))) {
+        uint64_t word = 0;
+        std::memcpy(&word, p, sizeof(word));
+        const auto quote = word ^ QUOTES;
+        const auto backslash = word ^ BACKSLASHES;
+        const auto slash = word ^ SLASHES;
+        const auto flags = ((quote - ONES) & ~quote) |
+                           ((backslash - ONES) & ~backslash) |
+                           ((slash - ONES) & ~slash) |
+                           ((word - SPACES) & ~word);
+        if ((flags & HIGHS) != 0) {
+            break;
+        }
+        p += sizeof(word);
+    }
+    while (p != end && !isEscaped(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+bool indexStructurals(const char* const str, const size_t size,
+                      uint32_t* const positions, size_t& count) {
+    using Kernel = bool (*)(const char*, size_t, uint32_t*, size_t&);
+    static const Kernel kernel = hasAvx2()   ? indexStructuralsAvx2
+                                 : hasSse2() ? indexStructuralsSse2
+                                             : indexStructuralsScalar;
+    return kernel(str, size, positions, count);
+}
+
+bool indexStructuralsScalar(const char* const str, const size_t size,
+                            uint32_t* const positions, size_t& count) {
+    return indexBlocks<classifyScalar>(str, size, positions, count);
+}
+
+#ifdef SIMPLEJSON_SSE2
+
+SIMPLEJSON_NO_SANITIZE_ADDRESS
+const char* skipWhitespaceSse2(const char* const str) {
+    assert(str != nullptr);
+    const auto space = _mm_set1_epi8(' ');
+    const auto tab = _mm_set1_epi8('\t');
+    const auto lineFeed = _mm_set1_epi8('\n');
+    const auto carriageReturn = _mm_set1_epi8('\r');
+
+    // bytes of the first block before `str` are not part of the string
+    auto p = alignDown(str, SSE2_BLOCK);
+    auto skipped = static_cast<unsigned>(str - p);
+    while (true) {
+        const auto block =
+            _mm_load_si128(reinterpret_cast<const __m128i*>(p));
+        const auto ws = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(block, space),
+                         _mm_cmpeq_epi8(block, tab)),
+            _mm_or_si128(_mm_cmpeq_epi8(block, lineFeed),
+                         _mm_cmpeq_epi8(block, carriageReturn)));
+
+        auto mask = ~static_cast<uint32_t>(_mm_movemask_epi8(ws)) & 0xFFFFU;
+        mask &= 0xFFFFU << skipped;
+        if (mask != 0) {
+            return p + countTrailingZeros(mask);
+        }
+        p += SSE2_BLOCK;
+        skipped = 0;
+    }
+    // never goto here, the terminating NUL is not whitespace
+}
+
+SIMPLEJSON_NO_SANITIZE_ADDRESS SIMPLEJSON_TARGET_AVX2
+const char* skipWhitespaceAvx2(const char* const str) {
+    assert(str != nullptr);
+    const auto space = _mm256_set1_epi8(' ');
+    const auto tab = _mm256_set1_epi8('\t');
+    const auto lineFeed = _mm256_set1_epi8('\n');
+    const auto carriageReturn = _mm256_set1_epi8('\r');
+
+    // bytes of the first block before `str` are not part of the string
+    auto p = alignDown(str, AVX2_BLOCK);
+    auto skipped = static_cast<unsigned>(str - p);
+    while (true) {
+        const auto block =
+            _mm256_load_si256(reinterpret_cast<const __m256i*>(p));
+        const auto ws = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, space),
+                            _mm256_cmpeq_epi8(block, tab)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, lineFeed),
+                            _mm256_cmpeq_epi8(block, carriageReturn)));
+
+        auto mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(ws));
+        mask &= 0xFFFF'FFFFU << skipped;
+        if (mask != 0) {
+            return p + countTrailingZeros(mask);
+        }
+        p += AVX2_BLOCK;
+        skipped = 0;
+    }
+    // never goto here, the terminating NUL is not whitespace
+}
+
+SIMPLEJSON_NO_SANITIZE_ADDRESS
+const char* scanStringSse2(const char* const str) {
+    assert(str != nullptr);
+    const auto quote = _mm_set1_epi8('"');
+    const auto backslash = _mm_set1_epi8('\\');
+    const auto maxControl = _mm_set1_epi8(0x1F);
+
+    // bytes of the first block before `str` are not part of the string
+    auto p = alignDown(str, SSE2_BLOCK);
+    auto skipped = static_cast<unsigned>(str - p);
+    while (true) {
+        const auto block =
+            _mm_load_si128(reinterpret_cast<const __m128i*>(p));
+        // unsigned `block <= 0x1F` as `max(block, 0x1F) == 0x1F`
+        const auto special = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(block, quote),
+                         _mm_cmpeq_epi8(block, backslash)),
+            _mm_cmpeq_epi8(_mm_max_epu8(block, maxControl), maxControl));
+
+        auto mask = static_cast<uint32_t>(_mm_movemask_epi8(special));
+        mask &= 0xFFFFU << skipped;
+        if (mask != 0) {
+            return p + countTrailingZeros(mask);
+        }
+        p += SSE2_BLOCK;
+        skipped = 0;
+    }
+    // never goto here, the terminating NUL is a control char
+}
+
+SIMPLEJSON_NO_SANITIZE_ADDRESS SIMPLEJSON_TARGET_AVX2
+const char* scanStringAvx2(const char* const str) {
+    assert(str != nullptr);
+    const auto quote = _mm256_set1_epi8('"');
+    const auto backslash = _mm256_set1_epi8('\\');
+    const auto maxControl = _mm256_set1_epi8(0x1F);
+
+    // bytes of the first block before `str` are not part of the string
+    auto p = alignDown(str, AVX2_BLOCK);
+    auto skipped = static_cast<unsigned>(str - p);
+    while (true) {
+        const auto block =
+            _mm256_load_si256(reinterpret_cast<const __m256i*>(p));
+        // unsigned `block <= 0x1F` as `max(block, 0x1F) == 0x1F`
+        const auto special = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, quote),
+                            _mm256_cmpeq_epi8(block, backslash)),
+            _mm256_cmpeq_epi8(_mm256_max_epu8(block, maxControl),
+                              maxControl));
+
+        auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(special));
+        mask &= 0xFFFF'FFFFU << skipped;
+        if (mask != 0) {
+            return p + countTrailingZeros(mask);
+        }
+        p += AVX2_BLOCK;
+        skipped = 0;
+    }
+    // never goto here, the terminating NUL is a control char
+}
+
+const char* scanStringUntilSse2(const char* const begin,
+                                const char* const end) {
+    assert(begin <= end);
+    const auto quote = _mm_set1_epi8('"');
+    const auto backslash = _mm_set1_epi8('\\');
+    const auto maxControl = _mm_set1_epi8(0x1F);
+
+    // unaligned blocks within the range, the rest a word at a time
+    auto p = begin;
+    while (end - p >= static_cast<ptrdiff_t>(SSE2_BLOCK)) {
+        const auto block =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const auto special = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(block, quote),
+                         _mm_cmpeq_epi8(block, backslash)),
+            _mm_cmpeq_epi8(_mm_max_epu8(block, maxControl), maxControl));
+
+        const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(special));
+        if (mask != 0) {
+            return p + countTrailingZeros(mask);
+        }
+        p += SSE2_BLOCK;
+    }
+    return scanStringUntilSwar(p, end);
+}
+
+SIMPLEJSON_TARGET_AVX2
+const char* scanStringUntilAvx2(const char* const begin,
+                                const char* const end) {
+    assert(begin <= end);
+    const auto quote = _mm256_set1_epi8('"');
+    const auto backslash = _mm256_set1_epi8('\\');
+    const auto maxControl = _mm256_set1_epi8(0x1F);
+
+    // unaligned blocks within the range, the rest a smaller block at a time
+    auto p = begin;
+    while (end - p >= static_cast<ptrdiff_t>(AVX2_BLOCK)) {
+        const auto block =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const auto special = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, quote),
+                            _mm256_cmpeq_epi8(block, backslash)),
+            _mm256_cmpeq_epi8(_mm256_max_epu8(block, maxControl),
+                              maxControl));
+
+        const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(special));
+        if (mask != 0) {
+            return p + countTrailingZeros(mask);
+        }
+        p += AVX2_BLOCK;
+    }
+    // the upper halves are cleared for the SSE code after this, see
+    // findEscapeAvx2
+    _mm256_zeroupper();
+    return scanStringUntilSse2(p, end);
+}
+
+const char* findEscapeSse2(const char* const begin, const char* const end) {
+    assert(begin <= end);
+    const auto quote = _mm_set1_epi8('"');
+    const auto backslash = _mm_set1_epi8('\\');
+    const auto slash = _mm_set1_epi8('/');
+    const auto maxControl = _mm_set1_epi8(0x1F);
+
+    // unaligned blocks within the range, the rest a word at a time
+    auto p = begin;
+    while (end - p >= static_cast<ptrdiff_t>(SSE2_BLOCK)) {
+        const auto block =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const auto escaped = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(block, quote),
+                         _mm_cmpeq_epi8(block, backslash)),
+            _mm_or_si128(
+                _mm_cmpeq_epi8(block, slash),
+                _mm_cmpeq_epi8(_mm_max_epu8(block, maxControl), maxControl)));
+
+        const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(escaped));
+        if (mask != 0) {
+            return p + countTrailingZeros(mask);
+        }
+        p += SSE2_BLOCK;
+    }
+    return findEscapeSwar(p, end);
+}
+
+SIMPLEJSON_TARGET_AVX2
+const char* findEscapeAvx2(const char* const begin, const char* const end) {
+    assert(begin <= end);
+    const auto quote = _mm256_set1_epi8('"');
+    const auto backslash = _mm256_set1_epi8('\\');
+    const auto slash = _mm256_set1_epi8('/');
+    const auto maxControl = _mm256_set1_epi8(0x1F);
+
+    // unaligned blocks within the range, the rest a smaller block at a time
+    auto p = begin;
+    while (end - p >= static_cast<ptrdiff_t>(AVX2_BLOCK)) {
+        const auto block =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const auto escaped = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, quote),
+                            _mm256_cmpeq_epi8(block, backslash)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(block, slash),
+                            _mm256_cmpeq_epi8(
+                                _mm256_max_epu8(block, maxControl),
+                                maxControl)));
+
+        const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(escaped));
+        if (mask != 0) {
+            return p + countTrailingZeros(mask);
+        }
+        p += AVX2_BLOCK;
+    }
+    // the compiler may hand over without clearing the upper halves, which
+    // would slow down any SSE code running after this until they are cleared
+    _mm256_zeroupper();
+    return findEscapeSse2(p, end);
+}
+
+bool indexStructuralsSse2(const char* const str, const size_t size,
+                          uint32_t* const positions, size_t& count) {
+    return indexBlocks<classifySse2>(str, size, positions, count);
+}
+
+bool indexStructuralsAvx2(const char* const str, const size_t size,
+                          uint32_t* const positions, size_t& count) {
+    return indexBlocks<classifyAvx2>(str, size, positions, count);
+}
+
+bool hasSse2() {
+    return true;
+}
+
+bool hasAvx2() {
+#if defined(__GNUC__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#elif defined(_MSC_VER)
+    constexpr auto OSXSAVE_BIT = 1 << 27;
+    constexpr auto AVX_BIT = 1 << 28;
+    constexpr auto AVX2_BIT = 1 << 5;
+    constexpr auto YMM_STATE = 0x6;
+
+    int info[4];  // NOLINT(modernize-avoid-c-arrays)
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    if ((info[2] & OSXSAVE_BIT) == 0 || (info[2] & AVX_BIT) == 0) {
+        return false;
+    }
+    // the OS must save the YMM registers on context switch
+    if ((_xgetbv(0) & YMM_STATE) != YMM_STATE) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & AVX2_BIT) != 0;
+#else
+    return false;
+#endif
+}
+
+#else  // SIMPLEJSON_SSE2
+
+// no vector kernels on this target, keep the entry points for callers
+const char* skipWhitespaceSse2(const char* const str) {
+    return skipWhitespaceScalar(str);
+}
+
+const char* skipWhitespaceAvx2(const char* const str) {
+    return skipWhitespaceScalar(str);
+}
+
+const char* scanStringSse2(const char* const str) {
+    return scanStringSwar(str);
+}
+
+const char* scanStringAvx2(const char* const str) {
+    return scanStringSwar(str);
+}
+
+const char* scanStringUntilSse2(const char* const begin,
+                                const char* const end) {
+    return scanStringUntilSwar(begin, end);
+}
+
+const char* scanStringUntilAvx2(const char* const begin,
+                                const char* const end) {
+    return scanStringUntilSwar(begin, end);
+}
+
+const char* findEscapeSse2(const char* const begin, const char* const end) {
+    return findEscapeSwar(begin, end);
+}
+
+const char* findEscapeAvx2(const char* const begin, const char* const end) {
+    return findEscapeSwar(begin, end);
+}
+
+bool indexStructuralsSse2(const char* const str, const size_t size,
+                          uint32_t* const positions, size_t& count) {
+    return indexStructuralsScalar(str, size, positions, count);
+}
+
+bool indexStructuralsAvx2(const char* const str, const size_t size,
+                          uint32_t* const positions, size_t& count) {
+    return indexStructuralsScalar(str, size, positions, count);
+}
+
+bool hasSse2() {
+    return false;
+}
+
+bool hasAvx2() {
+    return false;
+}
+
+#endif  // SIMPLEJSON_SSE2
+
+}  // namespace SimpleJson::Simd
+
+// ===== helpers =====
+namespace {
+
+uint64_t StructuralScanner::next(const BlockMasks& masks) {
+    constexpr uint64_t ODD_BITS = 0xAAAA'AAAA'AAAA'AAAAULL;
+    constexpr unsigned LAST_BIT = 63;
+
+    // a backslash not escaped itself escapes the next char: subtracting
+    // the starts of backslash runs from their ends flips the parity of the
+    // bits past each run, marking those after a run of odd length
+    const auto backslash = masks.backslash & ~_escaped;
+    const auto escapeAndEnd =
+        (((backslash << 1U) | ODD_BITS) - backslash) ^ ODD_BITS;
+    const auto escaped = escapeAndEnd ^ (masks.backslash | _escaped);
+    _escaped = (escapeAndEnd & masks.backslash) >> LAST_BIT;
+
+    // chars from an opening quotation mark up to its closing one, excluded
+    const auto quote = masks.quote & ~escaped;
+    const auto inString = prefixXor(quote) ^ _inString;
+    _inString = 0 - (inString >> LAST_BIT);
+
+    // brackets, colons and commas, and the first char of each scalar,
+    // which is neither an op nor whitespace and does not follow a scalar
+    // char; the rest of each string, closing quotation mark included, is
+    // not structural
+    const auto scalar = ~(masks.op | masks.whitespace);
+    const auto nonQuoteScalar = scalar & ~quote;
+    const auto followsScalar = (nonQuoteScalar << 1U) | _scalar;
+    _scalar = nonQuoteScalar >> LAST_BIT;
+    const auto stringTail = inString ^ quote;
+    return (masks.op | (scalar & ~followsScalar)) & ~stringTail;
+}
+
+BlockMasks classifyScalar(const char* const block) {
+    BlockMasks masks;
+    for (unsigned i = 0; i < 64; ++i) {
+        const auto bit = uint64_t(1) << i;
+        switch (block[i]) {
+            case '\\':
+                masks.backslash |= bit;
+                break;
+            case '"':
+                masks.quote |= bit;
+                break;
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r':
+                masks.whitespace |= bit;
+                break;
+            case '{':
+            case '}':
+            case '[':
+            case ']':
+            case ':':
+            case ',':
+                masks.op |= bit;
+                break;
+            default:
+                break;
+        }
+    }
+    return masks;
+}
+
+template <BlockMasks (*classify)(const char*)>
+bool indexBlocks(const char* const str, const size_t size,
+                 uint32_t* const positions, size_t& count) {
+    constexpr size_t BLOCK = 64;
+    StructuralScanner scanner;
+    auto* out = positions;
+    const auto flatten = [&out](uint64_t bits, const size_t offset) {
+        while (bits != 0) {
+            *out++ = static_cast<uint32_t>(offset) +
+                     static_cast<uint32_t>(countTrailingZeros64(bits));
+            bits &= bits - 1;
+        }
+    };
+
+    size_t offset = 0;
+    for (; size - offset >= BLOCK; offset += BLOCK) {
+        flatten(scanner.next(classify(str + offset)), offset);
+    }
+    if (offset != size) {
+        // the last partial block, padded with whitespace
+        char block[BLOCK];  // NOLINT(modernize-avoid-c-arrays)
+        std::memset(block, ' ', BLOCK);
+        std::memcpy(block, str + offset, size - offset);
+        flatten(scanner.next(classify(block)), offset);
+    }
+
+    count = static_cast<size_t>(out - positions);
+    return !scanner.inString();
+}
+
+int countTrailingZeros64(const uint64_t mask) {
+    assert(mask != 0);
+#ifdef _MSC_VER
+    unsigned long index = 0;
+    _BitScanForward64(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(mask);
+#endif
+}
+
+uint64_t prefixXor(uint64_t mask) {
+    for (unsigned shift = 1; shift < 64; shift *= 2) {
+        mask ^= mask << shift;
+    }
+    return mask;
+}
+
+uint64_t placeBits(const int mask, const unsigned shift) {
+    return uint64_t(static_cast<uint32_t>(mask)) << shift;
+}
+
+}  // namespace
+
+#ifdef SIMPLEJSON_SSE2
+
+// ===== helpers =====
+namespace {
+
+int countTrailingZeros(const uint32_t mask) {
+    assert(mask != 0);
+#ifdef _MSC_VER
+    unsigned long index = 0;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+const char* alignDown(const char* const str, const uintptr_t alignment) {
+    const auto address = reinterpret_cast<uintptr_t>(str);
+    return reinterpret_cast<const char*>(address & ~(alignment - 1));
+}
+
+BlockMasks classifySse2(const char* const block) {
+    const auto backslash = _mm_set1_epi8('\\');
+    const auto quote = _mm_set1_epi8('"');
+    const auto space = _mm_set1_epi8(' ');
+    const auto tab = _mm_set1_epi8('\t');
+    const auto lineFeed = _mm_set1_epi8('\n');
+    const auto carriageReturn = _mm_set1_epi8('\r');
+    // '{' '}' '[' ']' are 0x7B 0x7D 0x5B 0x5D, equal once 0x20 is set
+    const auto caseBit = _mm_set1_epi8(0x20);
+    const auto openBracket = _mm_set1_epi8('{');
+    const auto closeBracket = _mm_set1_epi8('}');
+    const auto colon = _mm_set1_epi8(':');
+    const auto comma = _mm_set1_epi8(',');
+
+    BlockMasks masks;
+    for (unsigned i = 0; i < 64; i += SSE2_BLOCK) {
+        const auto chars =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+        const auto folded = _mm_or_si128(chars, caseBit);
+        const auto ws = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chars, space),
+                         _mm_cmpeq_epi8(chars, tab)),
+            _mm_or_si128(_mm_cmpeq_epi8(chars, lineFeed),
+                         _mm_cmpeq_epi8(chars, carriageReturn)));
+        const auto op = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(folded, openBracket),
+                         _mm_cmpeq_epi8(folded, closeBracket)),
+            _mm_or_si128(_mm_cmpeq_epi8(chars, colon),
+                         _mm_cmpeq_epi8(chars, comma)));
+        masks.backslash |= placeBits(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(chars, backslash)), i);
+        masks.quote |=
+            placeBits(_mm_movemask_epi8(_mm_cmpeq_epi8(chars, quote)), i);
+        masks.whitespace |= placeBits(_mm_movemask_epi8(ws), i);
+        masks.op |= placeBits(_mm_movemask_epi8(op), i);
+    }
+    return masks;
+}
+
+SIMPLEJSON_TARGET_AVX2
+BlockMasks classifyAvx2(const char* const block) {
+    const auto backslash = _mm256_set1_epi8('\\');
+    const auto quote = _mm256_set1_epi8('"');
+    const auto space = _mm256_set1_epi8(' ');
+    const auto tab = _mm256_set1_epi8('\t');
+    const auto lineFeed = _mm256_set1_epi8('\n');
+    const auto carriageReturn = _mm256_set1_epi8('\r');
+    // '{' '}' '[' ']' are 0x7B 0x7D 0x5B 0x5D, equal once 0x20 is set
+    const auto caseBit = _mm256_set1_epi8(0x20);
+    const auto openBracket = _mm256_set1_epi8('{');
+    const auto closeBracket = _mm256_set1_epi8('}');
+    const auto colon = _mm256_set1_epi8(':');
+    const auto comma = _mm256_set1_epi8(',');
+
+    BlockMasks masks;
+    for (unsigned i = 0; i < 64; i += AVX2_BLOCK) {
+        const auto chars =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i));
+        const auto folded = _mm256_or_si256(chars, caseBit);
+        const auto ws = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chars, space),
+                            _mm256_cmpeq_epi8(chars, tab)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(chars, lineFeed),
+                            _mm256_cmpeq_epi8(chars, carriageReturn)));
+        const auto op = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(folded, openBracket),
+                            _mm256_cmpeq_epi8(folded, closeBracket)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(chars, colon),
+                            _mm256_cmpeq_epi8(chars, comma)));
+        masks.backslash |= placeBits(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(chars, backslash)), i);
+        masks.quote |=
+            placeBits(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chars, quote)), i);
+        masks.whitespace |= placeBits(_mm256_movemask_epi8(ws), i);
+        masks.op |= placeBits(_mm256_movemask_epi8(op), i);
+    }
+    return masks;
+}
+
+}  // namespace
+
+#endif  // SIMPLEJSON_SSE2
@@ -0,0 +1,79 @@
+#ifndef SIMPLEJSON_SIMD_H
+#define SIMPLEJSON_SIMD_H
+
+// Internal byte-scanning kernels shared by Reader and Writer.
+//
+// Kernels taking a NUL-terminated `str` load whole 8/16/32-byte aligned
+// blocks, so they may read past the terminator but never across the page
+// holding it; kernels taking a `[begin, end)` range never read past `end`.
+// Each has a portable, an SSE2 and an AVX2 variant; the plain
+// entry point dispatches at runtime to the best one the CPU supports.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace SimpleJson::Simd {
+
+/// ws = %x20 / %x09 / %x0A / %x0D
+inline bool isWhitespace(const char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/// ws = *(%x20 / %x09 / %x0A / %x0D), return the first char past `ws`
+const char* skipWhitespace(const char* str);
+
+// variants, exposed for tests and benchmarks
+const char* skipWhitespaceScalar(const char* str);
+const char* skipWhitespaceSse2(const char* str);
+const char* skipWhitespaceAvx2(const char* str);
+
+/// unescaped = %x20-21 / %x23-5B / %x5D-10FFFF, return the first char past
+/// `unescaped`, i.e. a quotation mark, a reverse solidus or a control char
+const char* scanString(const char* str);
+
+// variants, exposed for tests and benchmarks
+const char* scanStringSwar(const char* str);
+const char* scanStringSse2(const char* str);
+const char* scanStringAvx2(const char* str);
+
+/// the first char in [begin, end) past `unescaped`, as scanString, or `end`
+/// if none, for a document not terminated by a NUL
+const char* scanStringUntil(const char* begin, const char* end);
+
+// variants, exposed for tests and benchmarks
+const char* scanStringUntilSwar(const char* begin, const char* end);
+const char* scanStringUntilSse2(const char* begin, const char* end);
+const char* scanStringUntilAvx2(const char* begin, const char* end);
+
+/// the first char in [begin, end) that Writer escapes, i.e. a quotation
+/// mark, a reverse solidus, a solidus or a control char, or `end` if none
+const char* findEscape(const char* begin, const char* end);
+
+// variants, exposed for tests and benchmarks
+const char* findEscapeSwar(const char* begin, const char* end);
+const char* findEscapeSse2(const char* begin, const char* end);
+const char* findEscapeAvx2(const char* begin, const char* end);
+
+/// find the structural chars of the `size` chars at `str`: the brackets,
+/// colons and commas outside strings, and the first char of each string,
+/// literal and number; store their positions in order to `positions`, which
+/// must have room for `size` of them, and set `count` to their number
+/// @return false if a string is not closed
+bool indexStructurals(const char* str, size_t size, uint32_t* positions,
+                      size_t& count);
+
+// variants, exposed for tests and benchmarks
+bool indexStructuralsScalar(const char* str, size_t size, uint32_t* positions,
+                            size_t& count);
+bool indexStructuralsSse2(const char* str, size_t size, uint32_t* positions,
+                          size_t& count);
+bool indexStructuralsAvx2(const char* str, size_t size, uint32_t* positions,
+                          size_t& count);
+
+/// check which variants the running CPU supports
+bool hasSse2();
+bool hasAvx2();
+
+}  // namespace SimpleJson::Simd
+
+#endif  // SIMPLEJSON_SIMD_H
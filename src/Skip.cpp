@@ -0,0 +1,88 @@
+#include "Skip.h"
+
+#include <cassert>
+
+#include "Simd.h"
+
+namespace SimpleJson {
+
+const char* skipValue(const char* p, const char* const pEnd,
+                      ParseResult& res) {
+    switch (*p) {
+        case '"':
+            return skipString(p, pEnd, res);
+        case '[':
+        case '{': {
+            // down to the matching bracket, skipping brackets in strings
+            const auto missBracket = *p == '['
+                                         ? ParseResult::MissSquareBracket
+                                         : ParseResult::MissCurlyBracket;
+            size_t depth = 0;
+            while (true) {
+                switch (*p) {
+                    case '"':
+                        p = skipString(p, pEnd, res);
+                        if (p == nullptr) {
+                            return nullptr;
+                        }
+                        continue;
+                    case '[':
+                    case '{':
+                        ++depth;
+                        break;
+                    case ']':
+                    case '}':
+                        if (--depth == 0) {
+                            return p + 1;
+                        }
+                        break;
+                    case '\0':
+                        if (p == pEnd) {
+                            res = missBracket;
+                            return nullptr;
+                        }
+                        break;
+                    default:
+                        break;
+                }
+                ++p;
+            }
+        }
+        default: {
+            // a literal or a number, up to the next structural char
+            const auto pBegin = p;
+            while (*p != ',' && *p != ']' && *p != '}' && *p != '\0' &&
+                   !Simd::isWhitespace(*p)) {
+                ++p;
+            }
+            if (p == pBegin) {
+                res = p == pEnd ? ParseResult::ExpectValue
+                                : ParseResult::InvalidValue;
+                return nullptr;
+            }
+            return p;
+        }
+    }
+}
+
+const char* skipString(const char* p, const char* const pEnd,
+                       ParseResult& res) {
+    assert(*p == '"');
+    ++p;
+    while (true) {
+        p = Simd::scanString(p);
+        if (*p == '"') {
+            return p + 1;
+        }
+        if (*p == '\\' && p + 1 != pEnd) {
+            // the escaped char cannot end the string
+            p += 2;
+            continue;
+        }
+        res = p == pEnd || p + 1 == pEnd ? ParseResult::MissQuotationMark
+                                         : ParseResult::InvalidStringChar;
+        return nullptr;
+    }
+}
+
+}  // namespace SimpleJson
@@ -0,0 +1,25 @@
+#ifndef SIMPLEJSON_SKIP_H
+#define SIMPLEJSON_SKIP_H
+
+// Internal scanner that passes over values without parsing them.
+//
+// Only brackets and quotation marks are matched, so that a value is
+// skipped at about the speed of finding its end: strings are not decoded,
+// numbers not converted, and what is between them not checked.
+
+#include "simplejson/Reader.h"
+
+namespace SimpleJson {
+
+/// skip the value at `p`, only matching its brackets and quotation marks;
+/// return the char past it, or null and set `res` on error
+/// @note `pEnd` must point to a NUL
+const char* skipValue(const char* p, const char* pEnd, ParseResult& res);
+
+/// skip the string at `p`, leaving its escapes unchecked; return the char
+/// past it, or null and set `res` on error
+const char* skipString(const char* p, const char* pEnd, ParseResult& res);
+
+}  // namespace SimpleJson
+
+#endif  // SIMPLEJSON_SKIP_H
@@ -0,0 +1,159 @@
+#include "simplejson/Stream.h"
+
+#include <cstring>
+#include <iterator>
+
+#include "Parallel.h"
+#include "Simd.h"
+#include "ValueBuilder.h"
+
+// helpers
+namespace {
+
+using SimpleJson::ParseResult;
+using SimpleJson::Reader;
+using SimpleJson::Value;
+
+/// the values parsed from a part of the buffer
+struct Batch {
+    // Start of the first value, past whitespace
+    const char* pBegin = nullptr;
+    // Past the last value and whitespace, or start of the value failed
+    const char* pNext = nullptr;
+    std::vector<Value> values;
+    ParseResult result = ParseResult::Ok;
+};
+
+/// parse the values starting before `pLast`, the last one may end past it
+/// @note `pEnd` must point to a NUL
+Batch parseBatch(Reader& reader, const char* pBegin, const char* pLast,
+                 const char* pEnd);
+
+/// parse the value at `p` into `value`; return the char past it, or null
+const char* parseOne(Reader& reader, const char* p, const char* pEnd,
+                     Value& value);
+
+/// the start of the line after `p`, or `pEnd` if none
+const char* nextLine(const char* p, const char* pEnd);
+
+}  // namespace
+
+namespace SimpleJson {
+
+DocumentStream::DocumentStream(const char* const pBuffer)
+    : _pBegin(pBuffer),
+      _pCur(pBuffer),
+      _pEnd(pBuffer + std::strlen(pBuffer)) {}
+
+DocumentStream::DocumentStream(const std::string& buffer)
+    : _pBegin(buffer.data()),
+      _pCur(buffer.data()),
+      _pEnd(buffer.data() + buffer.size()) {}
+
+bool DocumentStream::next(Value& value) {
+    if (!good()) {
+        return false;
+    }
+    _pCur = Simd::skipWhitespace(_pCur);
+    if (_pCur == _pEnd) {
+        return false;
+    }
+
+    const auto pNext = parseOne(_reader, _pCur, _pEnd, value);
+    if (pNext == nullptr) {
+        _result = _reader.result();
+        return false;
+    }
+    _pCur = pNext;
+    return true;
+}
+
+bool DocumentStream::parseAll(std::vector<Value>& values,
+                              const unsigned threadCount,
+                              const size_t batchSize) {
+    if (!good()) {
+        return false;
+    }
+    _pCur = Simd::skipWhitespace(_pCur);
+
+    // bounds of the batches, each after a newline
+    std::vector<const char*> bounds{_pCur};
+    while (threadCount > 1 &&
+           static_cast<size_t>(_pEnd - bounds.back()) > batchSize) {
+        const auto p = nextLine(bounds.back() + batchSize, _pEnd);
+        if (p == _pEnd) {
+            break;
+        }
+        bounds.push_back(p);
+    }
+    bounds.push_back(_pEnd);
+
+    // a batch per task, each with a reader of its own
+    const auto batchCount = bounds.size() - 1;
+    std::vector<Batch> batches(batchCount);
+    forEachParallel(batchCount, threadCount, [&](const size_t i) {
+        Reader reader;
+        batches[i] = parseBatch(reader, bounds[i], bounds[i + 1], _pEnd);
+    });
+
+    // in order, each batch taking over where the previous one ended
+    for (size_t i = 0; i < batchCount; ++i) {
+        auto& batch = batches[i];
+        if (batch.pBegin != _pCur) {
+            // the previous batch ended within this one
+            batch = parseBatch(_reader, _pCur, bounds[i + 1], _pEnd);
+        }
+        values.insert(values.end(),
+                      std::make_move_iterator(batch.values.begin()),
+                      std::make_move_iterator(batch.values.end()));
+        _pCur = batch.pNext;
+        if (batch.result != ParseResult::Ok) {
+            _result = batch.result;
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace SimpleJson
+
+// ===== helpers =====
+namespace {
+
+Batch parseBatch(Reader& reader, const char* const pBegin,
+                 const char* const pLast, const char* const pEnd) {
+    Batch batch;
+    auto p = SimpleJson::Simd::skipWhitespace(pBegin);
+    batch.pBegin = p;
+    while (p < pLast) {
+        Value value;
+        const auto pNext = parseOne(reader, p, pEnd, value);
+        if (pNext == nullptr) {
+            batch.result = reader.result();
+            break;
+        }
+        batch.values.push_back(std::move(value));
+        p = SimpleJson::Simd::skipWhitespace(pNext);
+    }
+    batch.pNext = p;
+    return batch;
+}
+
+const char* parseOne(Reader& reader, const char* const p,
+                     const char* const pEnd, Value& value) {
+    SimpleJson::ValueBuilder builder(value, std::pmr::get_default_resource(),
+                                     nullptr, false);
+    const auto pNext = reader.parsePrefix(p, pEnd, builder);
+    if (pNext == nullptr) {
+        value = Value();
+    }
+    return pNext;
+}
+
+const char* nextLine(const char* const p, const char* const pEnd) {
+    const auto pNewline = static_cast<const char*>(
+        std::memchr(p, '\n', static_cast<size_t>(pEnd - p)));
+    return pNewline == nullptr ? pEnd : pNewline + 1;
+}
+
+}  // namespace
@@ -0,0 +1,330 @@
+#include "simplejson/Tape.h"
+
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+#include <variant>
+
+// helpers
+namespace {
+
+using SimpleJson::Bool;
+using SimpleJson::Integer;
+using SimpleJson::Real;
+using SimpleJson::UInteger;
+using SimpleJson::ValueType;
+
+// the type of a value is in the top byte of its first word, a payload below
+constexpr unsigned TYPE_SHIFT = 56;
+constexpr uint64_t PAYLOAD_MASK = (uint64_t(1) << TYPE_SHIFT) - 1;
+
+/// the first word of a value
+uint64_t makeWord(ValueType type, uint64_t payload);
+
+/// Reader handler that appends the values parsed to a tape
+class TapeBuilder {
+public:
+    TapeBuilder(std::vector<uint64_t>& tape, std::string& strings)
+        : _tape(tape), _strings(strings) {}
+
+    void onNull() { _tape.push_back(makeWord(ValueType::Null, 0)); }
+    void onBool(const Bool val) {
+        _tape.push_back(makeWord(ValueType::Bool, val ? 1 : 0));
+    }
+    void onInteger(const Integer val) {
+        addNumber(ValueType::Integer, static_cast<uint64_t>(val));
+    }
+    void onUInteger(const UInteger val) {
+        addNumber(ValueType::UInteger, val);
+    }
+    void onReal(const Real val) {
+        uint64_t bits = 0;
+        std::memcpy(&bits, &val, sizeof(bits));
+        addNumber(ValueType::Real, bits);
+    }
+    void onString(const std::string_view str) { addString(str); }
+    void onStartArray() { open(ValueType::Array); }
+    void onEndArray(const size_t size) { close(size); }
+    void onStartObject() { open(ValueType::Object); }
+    void onKey(const std::string_view key) { addString(key); }
+    void onEndObject(const size_t size) { close(size); }
+
+private:
+    void addNumber(const ValueType type, const uint64_t bits) {
+        _tape.push_back(makeWord(type, 0));
+        _tape.push_back(bits);
+    }
+
+    void addString(const std::string_view str) {
+        _tape.push_back(makeWord(ValueType::String, _strings.size()));
+        _tape.push_back(str.size());
+        _strings.append(str);
+        _strings.push_back('\0');
+    }
+
+    /// the position past the end and the size are set when closed
+    void open(const ValueType type) {
+        _open.push_back(_tape.size());
+        _tape.push_back(makeWord(type, 0));
+        _tape.push_back(0);
+    }
+
+    void close(const size_t size) {
+        const auto pos = _open.back();
+        _open.pop_back();
+        _tape[pos] |= _tape.size();
+        _tape[pos + 1] = size;
+    }
+
+    std::vector<uint64_t>& _tape;
+    std::string& _strings;
+    // Positions of the containers not closed yet, innermost last
+    std::vector<size_t> _open;
+};
+
+}  // namespace
+
+namespace SimpleJson {
+
+bool TapeDocument::parse(const char* const pDocument) {
+    return parseInto(pDocument);
+}
+
+bool TapeDocument::parse(const std::string& document) {
+    return parseInto(document);
+}
+
+template <typename Source>
+bool TapeDocument::parseInto(const Source& source) {
+    // keep the capacity of the previous document
+    _tape.clear();
+    _strings.clear();
+    TapeBuilder builder(_tape, _strings);
+    if (!_reader.parse(source, builder)) {
+        _tape.assign(1, makeWord(ValueType::Null, 0));
+        _strings.clear();
+        return false;
+    }
+    return true;
+}
+
+ValueType TapeValue::type() const {
+    return static_cast<ValueType>(word() >> TYPE_SHIFT);
+}
+
+Bool TapeValue::asBool() const {
+    checkType(ValueType::Bool);
+    return payload() != 0;
+}
+
+Integer TapeValue::asInteger() const {
+    checkType(ValueType::Integer);
+    return static_cast<Integer>(word(1));
+}
+
+UInteger TapeValue::asUInteger() const {
+    checkType(ValueType::UInteger);
+    return word(1);
+}
+
+Real TapeValue::asReal() const {
+    checkType(ValueType::Real);
+    const auto bits = word(1);
+    Real val = 0;
+    std::memcpy(&val, &bits, sizeof(val));
+    return val;
+}
+
+std::string_view TapeValue::asStringView() const {
+    checkType(ValueType::String);
+    return std::string_view(_document->_strings.data() + payload(), word(1));
+}
+
+std::string TapeValue::asString() const {
+    return std::string(this->asStringView());
+}
+
+const char* TapeValue::asCString() const {
+    return this->asStringView().data();
+}
+
+size_t TapeValue::size() const {
+    switch (this->type()) {
+        case ValueType::Array:
+        case ValueType::Object:
+            return word(1);
+        default:
+            return 0;
+    }
+}
+
+bool TapeValue::empty() const {
+    switch (this->type()) {
+        case ValueType::Null:
+            return true;
+        case ValueType::Array:
+        case ValueType::Object:
+            return word(1) == 0;
+        default:
+            return false;
+    }
+}
+
+TapeValue TapeValue::operator[](const size_t index) const {
+    checkType(ValueType::Array);
+    if (index >= word(1)) {
+        throw std::out_of_range("no such element: " + std::to_string(index));
+    }
+    auto pos = _pos + 2;
+    for (size_t i = 0; i < index; ++i) {
+        pos = TapeValue(_document, pos).next();
+    }
+    return TapeValue(_document, pos);
+}
+
+TapeValue TapeValue::operator[](const std::string_view key) const {
+    const auto pos = this->findMember(key);
+    if (pos == 0) {
+        throw std::out_of_range("no such member: " + std::string(key));
+    }
+    return TapeValue(_document, pos + 2);
+}
+
+bool TapeValue::isMember(const std::string_view key) const {
+    return this->findMember(key) != 0;
+}
+
+std::string_view TapeValue::getMemberName(const size_t index) const {
+    return TapeValue(_document, this->memberAt(index)).asStringView();
+}
+
+TapeValue TapeValue::getMemberValue(const size_t index) const {
+    return TapeValue(_document, this->memberAt(index) + 2);
+}
+
+TapeIterator TapeValue::begin() const {
+    // nothing to iterate in a scalar
+    const bool container = this->isArray() || this->isObject();
+    return TapeIterator(_document, container ? _pos + 2 : this->next(),
+                        this->isObject());
+}
+
+TapeIterator TapeValue::end() const {
+    return TapeIterator(_document, this->next(), this->isObject());
+}
+
+Value TapeValue::toValue(Value::MemoryResource* const resource) const {
+    switch (this->type()) {
+        case ValueType::Null:
+            return Value();
+        case ValueType::Bool:
+            return Value(this->asBool());
+        case ValueType::Integer:
+            return Value(this->asInteger());
+        case ValueType::UInteger:
+            return Value(this->asUInteger());
+        case ValueType::Real:
+            return Value(this->asReal());
+        case ValueType::String:
+            return Value(this->asStringView(), resource);
+        case ValueType::Array: {
+            Value res(ValueType::Array, resource);
+            res.resize(word(1));
+            auto pos = _pos + 2;
+            for (size_t i = 0; i < res.size(); ++i) {
+                const TapeValue element(_document, pos);
+                res[i] = element.toValue(resource);
+                pos = element.next();
+            }
+            return res;
+        }
+        case ValueType::Object: {
+            // the last of repeated keys, as operator[] finds and parse keeps
+            Value res(ValueType::Object, resource);
+            for (auto pos = _pos + 2; pos != payload();) {
+                const auto key = TapeValue(_document, pos).asStringView();
+                const TapeValue member(_document, pos + 2);
+                res[key] = member.toValue(resource);
+                pos = member.next();
+            }
+            return res;
+        }
+    }
+    // never goto here
+    return Value();
+}
+
+TapeIterator& TapeIterator::operator++() {
+    _pos = (**this).next();
+    return *this;
+}
+
+std::string_view TapeIterator::key() const {
+    assert(_member);
+    return TapeValue(_document, _pos).asStringView();
+}
+
+uint64_t TapeValue::word(const size_t offset) const {
+    assert(_pos + offset < _document->_tape.size());
+    return _document->_tape[_pos + offset];
+}
+
+uint64_t TapeValue::payload() const {
+    return word() & PAYLOAD_MASK;
+}
+
+/// the position past the value, a jump over a whole container
+size_t TapeValue::next() const {
+    switch (this->type()) {
+        case ValueType::Null:
+        case ValueType::Bool:
+            return _pos + 1;
+        case ValueType::Array:
+        case ValueType::Object:
+            return payload();
+        default:
+            return _pos + 2;
+    }
+}
+
+void TapeValue::checkType(const ValueType type) const {
+    if (this->type() != type) {
+        throw std::bad_variant_access();
+    }
+}
+
+size_t TapeValue::findMember(const std::string_view key) const {
+    checkType(ValueType::Object);
+    size_t found = 0;
+    for (auto pos = _pos + 2; pos != payload();) {
+        if (TapeValue(_document, pos).asStringView() == key) {
+            found = pos;
+        }
+        pos = TapeValue(_document, pos + 2).next();
+    }
+    return found;
+}
+
+size_t TapeValue::memberAt(const size_t index) const {
+    checkType(ValueType::Object);
+    if (index >= word(1)) {
+        throw std::out_of_range("no such member: " + std::to_string(index));
+    }
+    auto pos = _pos + 2;
+    for (size_t i = 0; i < index; ++i) {
+        pos = TapeValue(_document, pos + 2).next();
+    }
+    return pos;
+}
+
+}  // namespace SimpleJson
+
+// ===== helpers =====
+namespace {
+
+uint64_t makeWord(const ValueType type, const uint64_t payload) {
+    assert((payload & ~PAYLOAD_MASK) == 0);
+    return (static_cast<uint64_t>(type) << TYPE_SHIFT) | payload;
+}
+
+}  // namespace
@@ -1,10 +1,32 @@
 #include "simplejson/Value.h"
 
 #include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <new>
+#include <stdexcept>
+
+// helpers
+namespace {
+
+/// create an empty container allocated from `resource`
+template <typename P>
+P makeContainer(std::pmr::memory_resource* resource);
+
+/// hash of an object key
+size_t hashKey(std::string_view key);
+
+/// compare object keys, skipping the chars of a key compared with itself;
+/// different pointers may still hold equal keys, so they decide nothing
+bool equalKeys(std::string_view lhs, std::string_view rhs);
+
+}  // namespace
 
 namespace SimpleJson {
 
-Value::Value(ValueType type) {
+Value::Value(ValueType type, MemoryResource* const resource) {
     switch (type) {
         case ValueType::Null:
             _data = Null();
@@ -15,6 +37,9 @@ Value::Value(ValueType type) {
         case ValueType::Integer:
             _data = Integer();
             break;
+        case ValueType::UInteger:
+            _data = UInteger();
+            break;
         case ValueType::Real:
             _data = Real();
             break;
@@ -22,15 +47,15 @@ Value::Value(ValueType type) {
             _data = String();
             break;
         case ValueType::Array:
-            _data = std::make_unique<Array>();
+            _data = makeContainer<PArray>(resource);
             break;
         case ValueType::Object:
-            _data = std::make_unique<Object>();
+            _data = makeContainer<PObject>(resource);
             break;
     }
 }
 
-Value::Value(const Value& other) {
+Value::Value(const Value& other, MemoryResource* const resource) {
     switch (other.type()) {
         case ValueType::Null:
             _data = Null();
@@ -41,21 +66,52 @@ Value::Value(const Value& other) {
         case ValueType::Integer:
             _data = other.asInteger();
             break;
+        case ValueType::UInteger:
+            _data = other.asUInteger();
+            break;
         case ValueType::Real:
             _data = other.asReal();
             break;
         case ValueType::String:
-            _data = String(other.asStringView());
+            _data = String(std::get<String>(other._data), resource);
             break;
-        case ValueType::Array:
-            _data = std::make_unique<Array>(other.asArray());
+        case ValueType::Array: {
+            // copy elements one by one, so they share the resource
+            auto array = makeContainer<PArray>(resource);
+            array->reserve(other.size());
+            for (const auto& element : other.asArray()) {
+                array->emplace_back(element, resource);
+            }
+            _data = std::move(array);
             break;
-        case ValueType::Object:
-            _data = std::make_unique<Object>(other.asObject());
+        }
+        case ValueType::Object: {
+            // copy members one by one, so they share the resource
+            auto object = makeContainer<PObject>(resource);
+            object->reserve(other.size());
+            for (const auto& [key, value] : other.asObject()) {
+                object->append(String(key, resource), Value(value, resource));
+            }
+            _data = std::move(object);
             break;
+        }
     }
 }
 
+Value::Value(const UInteger val) {
+    if (val > static_cast<UInteger>(std::numeric_limits<Integer>::max())) {
+        _data = val;
+    } else {
+        _data = static_cast<Integer>(val);
+    }
+}
+
+Value Value::view(const std::string_view str) {
+    Value res;
+    res._data = String::view(str);
+    return res;
+}
+
 Value& Value::operator=(Value other) {
     this->swap(other);
     return *this;
@@ -77,14 +133,30 @@ bool operator==(const Value& lhs, const Value& rhs) {
             return lhs.asBool() == rhs.asBool();
         case ValueType::Integer:
             return lhs.asInteger() == rhs.asInteger();
+        case ValueType::UInteger:
+            return lhs.asUInteger() == rhs.asUInteger();
         case ValueType::Real:
             return lhs.asReal() == rhs.asReal();
         case ValueType::String:
             return lhs.asStringView() == rhs.asStringView();
         case ValueType::Array:
             return lhs.asArray() == rhs.asArray();
-        case ValueType::Object:
-            return lhs.asObject() == rhs.asObject();
+        case ValueType::Object: {
+            // members may be in any order
+            const auto& lhsObject = lhs.asObject();
+            const auto& rhsObject = rhs.asObject();
+            if (lhsObject.size() != rhsObject.size()) {
+                return false;
+            }
+            for (const auto& [key, value] : lhsObject) {
+                const auto index = rhsObject.find(key);
+                if (index == Value::Object::NPOS ||
+                    rhsObject[index].second != value) {
+                    return false;
+                }
+            }
+            return true;
+        }
     }
     // never goto here
     return false;
@@ -155,26 +227,41 @@ void Value::append(Value value) {
     this->asArray().push_back(std::move(value));
 }
 
-Value& Value::operator[](const std::string& key) {
+Value& Value::operator[](const std::string_view key) {
     return this->asObject()[key];
 }
 
-const Value& Value::operator[](const std::string& key) const {
-    return this->asObject().at(key);
+const Value& Value::operator[](const std::string_view key) const {
+    const auto& object = this->asObject();
+    const auto index = object.find(key);
+    if (index == Object::NPOS) {
+        throw std::out_of_range("no such member: " + std::string(key));
+    }
+    return object[index].second;
 }
 
-bool Value::isMember(const std::string& key) const {
-    return this->asObject().count(key) > 0;
+Value& Value::viewMember(const std::string_view key) {
+    auto& object = this->asObject();
+    const auto index = object.find(key);
+    if (index != Object::NPOS) {
+        return object[index].second;
+    }
+    return object.append(String::view(key), Value());
 }
 
-Value Value::removeMember(const std::string& key) {
-    if (!this->isMember(key)) {
+bool Value::isMember(const std::string_view key) const {
+    return this->asObject().find(key) != Object::NPOS;
+}
+
+Value Value::removeMember(const std::string_view key) {
+    auto& object = this->asObject();
+    const auto index = object.find(key);
+    if (index == Object::NPOS) {
         return Value();
     }
 
-    auto& object = this->asObject();
-    auto res = Value(std::move(object.at(key)));
-    object.erase(key);
+    auto res = Value(std::move(object[index].second));
+    object.erase(index);
 
     return res;
 }
@@ -183,22 +270,193 @@ std::vector<std::string> Value::getMemberNames() const {
     const auto& object = this->asObject();
     std::vector<std::string> res;
     res.reserve(object.size());
-    for (const auto& pair : object) {
-        res.push_back(pair.first);
+    for (const auto& [key, value] : object) {
+        res.emplace_back(key);
     }
     return res;
 }
 
-Value::String::String(std::string_view str) {
-    if (str.empty()) {
+std::string_view Value::getMemberName(const size_t index) const {
+    return this->asObject()[index].first;
+}
+
+const Value& Value::getMemberValue(const size_t index) const {
+    return this->asObject()[index].second;
+}
+
+size_t Value::Object::find(const std::string_view key) const {
+    if (_index.empty()) {
+        for (size_t i = 0; i < _members.size(); ++i) {
+            if (equalKeys(_members[i].first, key)) {
+                return i;
+            }
+        }
+        return NPOS;
+    }
+
+    const auto mask = _index.size() - 1;
+    for (auto slot = hashKey(key) & mask; _index[slot] != 0;
+         slot = (slot + 1) & mask) {
+        const size_t i = _index[slot] - 1;
+        if (equalKeys(_members[i].first, key)) {
+            return i;
+        }
+    }
+    return NPOS;
+}
+
+Value& Value::Object::operator[](const std::string_view key) {
+    const auto index = this->find(key);
+    if (index != NPOS) {
+        return _members[index].second;
+    }
+    // the key is allocated from the resource of the object
+    return this->append(String(key, _members.get_allocator().resource()),
+                        Value());
+}
+
+Value& Value::Object::append(String key, Value value) {
+    assert(this->find(key) == NPOS);
+    _members.emplace_back(std::move(key), std::move(value));
+    if (!_index.empty() || _members.size() > LINEAR_MAX) {
+        // keep at most half of the slots taken
+        if (_members.size() * 2 > _index.size()) {
+            this->rebuildIndex();
+        } else {
+            this->indexMember(_members.size() - 1);
+        }
+    }
+    return _members.back().second;
+}
+
+void Value::Object::erase(const size_t index) {
+    _members.erase(_members.begin() + static_cast<ptrdiff_t>(index));
+    // positions behind the member have shifted
+    if (_members.size() > LINEAR_MAX) {
+        this->rebuildIndex();
+    } else {
+        _index.clear();
+    }
+}
+
+void Value::Object::clear() {
+    _members.clear();
+    _index.clear();
+}
+
+void Value::Object::indexMember(const size_t index) {
+    const auto mask = _index.size() - 1;
+    auto slot = hashKey(_members[index].first) & mask;
+    while (_index[slot] != 0) {
+        slot = (slot + 1) & mask;
+    }
+    _index[slot] = static_cast<uint32_t>(index + 1);
+}
+
+void Value::Object::rebuildIndex() {
+    // a power of two, so that probing wraps by a mask
+    auto slots = 4 * LINEAR_MAX;
+    while (slots < 4 * _members.size()) {
+        slots *= 2;
+    }
+    _index.assign(slots, 0);
+    for (size_t i = 0; i < _members.size(); ++i) {
+        this->indexMember(i);
+    }
+}
+
+Value::String::String(std::string_view str, MemoryResource* const resource) {
+    assert(resource != nullptr);
+    if (str.size() <= INLINE_CAPACITY) {
+        str.copy(_storage.data(), str.size());
+        _storage.back() = static_cast<char>(INLINE_CAPACITY - str.size());
+        return;
+    }
+
+    // header of the resource, then the chars
+    constexpr auto HEADER_SIZE = sizeof(MemoryResource*);
+    auto* const block = static_cast<char*>(resource->allocate(
+        HEADER_SIZE + str.size() + 1, alignof(MemoryResource*)));
+    std::memcpy(block, &resource, HEADER_SIZE);
+
+    auto* const ptr = block + HEADER_SIZE;
+    str.copy(ptr, str.size());
+    ptr[str.size()] = 0;
+    this->setOutOfLine(ptr, str.size(), OWNED_TAG);
+}
+
+Value::String::String(const String& other, MemoryResource* const resource)
+    : String(other.isView() ? view(other)
+                            : String(std::string_view(other), resource)) {}
+
+Value::String Value::String::view(const std::string_view str) {
+    assert(str.data() == nullptr || str.data()[str.size()] == 0);
+    String res;
+    if (!str.empty()) {
+        res.setOutOfLine(str.data(), str.size(), VIEW_TAG);
+    }
+    return res;
+}
+
+Value::String::String(String&& other) noexcept : _storage(other._storage) {
+    // the moved-from string is left empty
+    other._storage = {};
+    other._storage.back() = INLINE_CAPACITY;
+}
+
+Value::String& Value::String::operator=(String&& other) noexcept {
+    std::swap(_storage, other._storage);
+    return *this;
+}
+
+Value::String::~String() {
+    if (this->tag() != OWNED_TAG) {
         return;
     }
 
-    // NOLINTNEXTLINE(modernize-avoid-c-arrays)
-    _ptr = std::make_unique<char[]>(str.size() + 1);
-    _size = str.size();
-    str.copy(_ptr.get(), _size);
-    _ptr[_size] = 0;
+    constexpr auto HEADER_SIZE = sizeof(MemoryResource*);
+    auto* const block = const_cast<char*>(this->pointer()) - HEADER_SIZE;
+    MemoryResource* resource = nullptr;
+    std::memcpy(&resource, block, HEADER_SIZE);
+    resource->deallocate(block, HEADER_SIZE + this->outOfLineSize() + 1,
+                         alignof(MemoryResource*));
+}
+
+void Value::String::setOutOfLine(const char* const ptr, const size_t size,
+                                 const unsigned char tag) {
+    assert(uint64_t(size) >> (8U * SIZE_BYTES) == 0);
+    std::memcpy(_storage.data(), &ptr, sizeof(ptr));
+    for (size_t i = 0; i < SIZE_BYTES; ++i) {
+        _storage[sizeof(char*) + i] =
+            static_cast<char>(uint64_t(size) >> (8U * i));
+    }
+    _storage.back() = static_cast<char>(tag);
 }
 
 }  // namespace SimpleJson
+
+// ===== helpers =====
+namespace {
+
+template <typename P>
+P makeContainer(std::pmr::memory_resource* const resource) {
+    assert(resource != nullptr);
+    using Container = typename P::element_type;
+    std::pmr::polymorphic_allocator<Container> allocator(resource);
+    auto* const ptr = allocator.allocate(1);
+    new (ptr) Container(resource);
+    return P(ptr);
+}
+
+size_t hashKey(const std::string_view key) {
+    return std::hash<std::string_view>()(key);
+}
+
+bool equalKeys(const std::string_view lhs, const std::string_view rhs) {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    return lhs.data() == rhs.data() || lhs == rhs;
+}
+
+}  // namespace
@@ -0,0 +1,96 @@
+#ifndef SIMPLEJSON_VALUEBUILDER_H
+#define SIMPLEJSON_VALUEBUILDER_H
+
+// Internal Reader handler that builds a value tree from parse events.
+//
+// Each container is created in its final place, in its parent or as the
+// root, and the builder keeps pointers to the open ones: a parent is not
+// modified while a child is open, so the pointers stay valid.
+
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "simplejson/KeyTable.h"
+#include "simplejson/Reader.h"
+#include "simplejson/Value.h"
+
+namespace SimpleJson {
+
+class ValueBuilder {
+public:
+    /// build into `root`, allocating from `resource`; strings refer to the
+    /// document if `insitu`, keys to `keyTable` unless it is null
+    ValueBuilder(Value& root, Value::MemoryResource* const resource,
+                 KeyTable* const keyTable, const bool insitu)
+        : _root(root),
+          _resource(resource),
+          _keyTable(keyTable),
+          _insitu(insitu) {}
+
+    void onNull() { add(Value()); }
+    void onBool(const Bool val) { add(val); }
+    void onInteger(const Integer val) { add(val); }
+    void onUInteger(const UInteger val) { add(val); }
+    void onReal(const Real val) { add(val); }
+    void onString(const std::string_view str) {
+        add(_insitu ? Value::view(str) : Value(str, _resource));
+    }
+    void onStartArray() { open(ValueType::Array); }
+    void onEndArray(size_t /*size*/) { _open.pop_back(); }
+    void onStartObject() { open(ValueType::Object); }
+    void onKey(const std::string_view key) {
+        // add the member now, the key is valid only during this call
+        auto& object = *_open.back();
+        _member = _keyTable != nullptr
+                      ? &object.viewMember(_keyTable->intern(key))
+                      : &object[key];
+    }
+    void onEndObject(size_t /*size*/) { _open.pop_back(); }
+
+    /// after a failed parse, empty the containers left open innermost
+    /// first, so that discarding the value takes no stack for their nesting
+    void clearOpen() {
+        for (auto it = _open.rbegin(); it != _open.rend(); ++it) {
+            (*it)->clear();
+        }
+        _open.clear();
+    }
+
+private:
+    /// place `value` in the innermost open container, or as the root
+    void add(Value value) {
+        if (_open.empty()) {
+            _root = std::move(value);
+        } else if (_open.back()->isArray()) {
+            _open.back()->append(std::move(value));
+        } else {
+            *_member = std::move(value);
+        }
+    }
+
+    /// place an empty container like a value, and open it
+    void open(const ValueType type) {
+        add(Value(type, _resource));
+        if (_open.empty()) {
+            _open.push_back(&_root);
+        } else if (auto& parent = *_open.back(); parent.isArray()) {
+            _open.push_back(&parent[parent.size() - 1]);
+        } else {
+            _open.push_back(_member);
+        }
+    }
+
+    Value& _root;
+    Value::MemoryResource* const _resource;
+    KeyTable* const _keyTable;
+    const bool _insitu;
+    // Containers not closed yet, innermost last
+    std::vector<Value*> _open;
+    // Member of the innermost object whose value is parsed next
+    Value* _member = nullptr;
+};
+
+}  // namespace SimpleJson
+
+#endif  // SIMPLEJSON_VALUEBUILDER_H
@@ -1,14 +1,109 @@
 #include "simplejson/Writer.h"
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <charconv>
+#include <cmath>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+#include "Number.h"
+#include "Parallel.h"
+#include "Simd.h"
+
+// helpers
+namespace {
+
+/// the char after the reverse solidus of each escaped char, 'u' for those
+/// written as \u00XX, or 0 for chars written as is
+constexpr std::array<char, 256> ESCAPES = [] {
+    std::array<char, 256> escapes{};
+    for (size_t c = 0; c < 0x20; ++c) {
+        escapes[c] = 'u';
+    }
+    escapes['"'] = '"';
+    escapes['\\'] = '\\';
+    escapes['/'] = '/';
+    escapes['\b'] = 'b';
+    escapes['\f'] = 'f';
+    escapes['\n'] = 'n';
+    escapes['\r'] = 'r';
+    escapes['\t'] = 't';
+    return escapes;
+}();
+
+// the longest shortest form is "-2.2250738585072014e-308" and a ".0"
+constexpr size_t REAL_BUF_SIZE = 32;
+
+/// the shortest form of `number` that reads back the same, always with a
+/// fraction or an exponent so that it reads back as a real
+size_t formatReal(double number, char* buf, size_t size);
+
+/// the shortest digits of `number` that read back the same, in the shorter
+/// of the fixed and the exponent forms, or always in the latter
+size_t formatShortest(double number, char* buf, size_t size,
+                      bool scientific);
+
+}  // namespace
 
 namespace SimpleJson {
 
 std::string Writer::write(const Value& root) {
+    std::string document;
+    write(root, document);
+    return document;
+}
+
+void Writer::write(const Value& root, std::string& document) {
+    // stringify straight into `document`, and hand it back even if
+    // stringifying throws, e.g. std::bad_alloc
+    _strBuf.swap(document);
+    try {
+        stringifyValue(root);
+    } catch (...) {
+        _strBuf.swap(document);
+        throw;
+    }
+    _strBuf.swap(document);
+}
+
+void Writer::write(const Value& root, const Sink& sink) {
     _strBuf.clear();
-    stringifyValue(root);
-    return _strBuf;
+    _strBuf.reserve(CHUNK_SIZE);
+    _sink = &sink;
+    try {
+        stringifyValue(root);
+    } catch (...) {
+        _sink = nullptr;
+        throw;
+    }
+    _sink = nullptr;
+
+    if (!_strBuf.empty()) {
+        sink(_strBuf);
+    }
+}
+
+bool Writer::write(const Value& root, std::ostream& os) {
+    write(root, [&os](const std::string_view chunk) {
+        os.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+    });
+    return os.good();
+}
+
+bool Writer::write(const Value& root, std::FILE* const file) {
+    assert(file != nullptr);
+    bool good = true;
+    write(root, [&](const std::string_view chunk) {
+        good = good && std::fwrite(chunk.data(), 1, chunk.size(), file) ==
+                           chunk.size();
+    });
+    return good;
 }
 
 void Writer::stringifyValue(const Value& root) {
@@ -20,7 +115,10 @@ void Writer::stringifyValue(const Value& root) {
             _strBuf += root.asBool() ? "true" : "false";
             break;
         case ValueType::Integer:
-            _strBuf += std::to_string(root.asInteger());
+            stringifyInteger(root.asInteger());
+            break;
+        case ValueType::UInteger:
+            stringifyInteger(root.asUInteger());
             break;
         case ValueType::Real:
             stringifyReal(root.asReal());
@@ -35,22 +133,25 @@ void Writer::stringifyValue(const Value& root) {
             stringifyObject(root);
             break;
     }
-}
 
-void Writer::stringifyReal(const Real number) {
-    constexpr auto bufSize = 32;
+    if (_sink != nullptr && _strBuf.size() >= CHUNK_SIZE) {
+        flushChunk();
+    }
+}
 
-    const auto currentLength = _strBuf.size();
-    _strBuf.resize(currentLength + bufSize);
+template <typename T>
+void Writer::stringifyInteger(const T number) {
+    // digits of the widest integer and a sign
+    std::array<char, std::numeric_limits<T>::digits10 + 2> buf{};
+    const auto res = std::to_chars(buf.data(), buf.data() + buf.size(), number);
+    assert(res.ec == std::errc());
+    _strBuf.append(buf.data(), res.ptr);
+}
 
-    const auto pBuf = _strBuf.data() + currentLength;
-    const auto res = std::snprintf(pBuf, bufSize, "%.17g", number);
-    if (res > 0) {
-        _strBuf.resize(currentLength + res);
-    } else {
-        _strBuf.resize(currentLength);
-        _strBuf += std::to_string(number);
-    }
+void Writer::stringifyReal(const Real number) {
+    std::array<char, REAL_BUF_SIZE> buf{};
+    const auto length = formatReal(number, buf.data(), buf.size());
+    _strBuf.append(buf.data(), length);
 }
 
 void Writer::stringifyString(std::string_view str) {
@@ -61,40 +162,27 @@ void Writer::stringifyString(std::string_view str) {
     // begin of string
     _strBuf.push_back('"');
 
-    // char
-    for (const char c : str) {
-        switch (c) {
-            case '"':
-            case '\\':
-            case '/':
-                _strBuf.push_back('\\');
-                _strBuf.push_back(c);
-                break;
-            case '\b':
-                _strBuf += "\\b";
-                break;
-            case '\f':
-                _strBuf += "\\f";
-                break;
-            case '\n':
-                _strBuf += "\\n";
-                break;
-            case '\r':
-                _strBuf += "\\r";
-                break;
-            case '\t':
-                _strBuf += "\\t";
-                break;
-            default:
-                if (static_cast<unsigned char>(c) < '\x20') {
-                    _strBuf += "\\u00";
-                    _strBuf.push_back(HEX_DIGITS[c >> 4]);
-                    _strBuf.push_back(HEX_DIGITS[c & 0xF]);
-                } else {
-                    _strBuf.push_back(c);
-                }
-                break;
+    // runs of plain chars, each followed by an escaped char or the end
+    auto p = str.data();
+    const auto end = p + str.size();
+    while (true) {
+        const auto escaped = Simd::findEscape(p, end);
+        _strBuf.append(p, escaped);
+        if (escaped == end) {
+            break;
         }
+
+        const auto c = static_cast<unsigned char>(*escaped);
+        const auto escape = ESCAPES[c];
+        assert(escape != 0);
+        _strBuf.push_back('\\');
+        _strBuf.push_back(escape);
+        if (escape == 'u') {
+            _strBuf += "00";
+            _strBuf.push_back(HEX_DIGITS[c >> 4U]);
+            _strBuf.push_back(HEX_DIGITS[c & 0xFU]);
+        }
+        p = escaped + 1;
     }
 
     // end of string
@@ -103,39 +191,234 @@ void Writer::stringifyString(std::string_view str) {
 
 void Writer::stringifyArray(const Value& root) {
     assert(root.isArray());
+    if (_threadCount > 1 && root.size() >= _parallelThreshold) {
+        stringifyParallel(root);
+        return;
+    }
 
     // begin of array
     _strBuf.push_back('[');
 
-    for (size_t i = 0; i < root.size(); ++i) {
-        if (i != 0) {
-            _strBuf.push_back(',');
-        }
-        stringifyValue(root[i]);
-    }
+    stringifyElements(root, 0, root.size());
 
-    // begin of array
+    // end of array
     _strBuf.push_back(']');
 }
 
 void Writer::stringifyObject(const Value& root) {
     assert(root.isObject());
+    if (_threadCount > 1 && root.size() >= _parallelThreshold) {
+        stringifyParallel(root);
+        return;
+    }
 
     // begin of object
     _strBuf.push_back('{');
 
-    const auto keys = root.getMemberNames();
-    for (size_t i = 0; i < keys.size(); ++i) {
-        if (i != 0) {
+    stringifyMembers(root, 0, root.size());
+
+    // end of object
+    _strBuf.push_back('}');
+}
+
+void Writer::stringifyElements(const Value& root, const size_t first,
+                               const size_t last) {
+    for (auto i = first; i < last; ++i) {
+        if (i != first) {
             _strBuf.push_back(',');
         }
-        stringifyString(keys[i]);
+        stringifyValue(root[i]);
+    }
+}
+
+void Writer::stringifyMembers(const Value& root, const size_t first,
+                              const size_t last) {
+    for (auto i = first; i < last; ++i) {
+        if (i != first) {
+            _strBuf.push_back(',');
+        }
+        stringifyString(root.getMemberName(i));
         _strBuf.push_back(':');
-        stringifyValue(root[keys[i]]);
+        stringifyValue(root.getMemberValue(i));
     }
+}
 
-    // begin of object
-    _strBuf.push_back('}');
+/// slices of a large array or object, a few per thread to balance them;
+/// for a sink, slices of about `_parallelThreshold` elements or members, a
+/// wave of one per thread at a time, so that only those are held at once;
+/// each wave starts its own threads, little against the slices they write
+void Writer::stringifyParallel(const Value& root) {
+    const bool object = root.isObject();
+    const auto size = root.size();
+    auto sliceCount = std::min<size_t>(size, _threadCount * 4);
+    auto waveSize = sliceCount;
+    if (_sink != nullptr) {
+        sliceCount = std::max(
+            sliceCount, size / std::max<size_t>(_parallelThreshold, 1));
+        waveSize = std::min<size_t>(sliceCount, _threadCount);
+    }
+
+    std::vector<std::string> slices(waveSize);
+    _strBuf.push_back(object ? '{' : '[');
+    for (size_t wave = 0; wave < sliceCount; wave += waveSize) {
+        const auto count = std::min(waveSize, sliceCount - wave);
+        forEachParallel(count, _threadCount, [&](const size_t j) {
+            // containers within are written on this thread only
+            Writer writer;
+            const auto first = size * (wave + j) / sliceCount;
+            const auto last = size * (wave + j + 1) / sliceCount;
+            if (object) {
+                writer.stringifyMembers(root, first, last);
+            } else {
+                writer.stringifyElements(root, first, last);
+            }
+            slices[j] = std::move(writer._strBuf);
+        });
+
+        for (size_t j = 0; j < count; ++j) {
+            if (wave + j != 0) {
+                _strBuf.push_back(',');
+            }
+            appendSlice(slices[j]);
+            // free each slice once written
+            std::string().swap(slices[j]);
+        }
+    }
+    _strBuf.push_back(object ? '}' : ']');
+}
+
+void Writer::appendSlice(const std::string_view slice) {
+    if (_sink == nullptr) {
+        _strBuf += slice;
+        return;
+    }
+
+    // hand it to the sink in chunks, without a copy
+    if (!_strBuf.empty()) {
+        flushChunk();
+    }
+    for (size_t pos = 0; pos < slice.size(); pos += CHUNK_SIZE) {
+        (*_sink)(slice.substr(pos, CHUNK_SIZE));
+    }
+}
+
+void Writer::flushChunk() {
+    assert(_sink != nullptr);
+    (*_sink)(_strBuf);
+    _strBuf.clear();
 }
 
 }  // namespace SimpleJson
+
+// ===== helpers =====
+namespace {
+
+size_t formatReal(const double number, char* const buf, const size_t size) {
+    assert(size >= REAL_BUF_SIZE);
+    auto length = formatShortest(number, buf, size, false);
+    if (!std::isfinite(number) ||
+        std::any_of(buf, buf + length, [](const char c) {
+            return c == '.' || c == 'e' || c == 'E';
+        })) {
+        return length;
+    }
+
+    // an integral real keeps a fraction, or an exponent if shorter
+    std::array<char, REAL_BUF_SIZE> scientific{};
+    const auto scientificLength =
+        formatShortest(number, scientific.data(), scientific.size(), true);
+    if (scientificLength < length + 2) {
+        std::copy_n(scientific.begin(), scientificLength, buf);
+        return scientificLength;
+    }
+    assert(length + 2 <= size);
+    buf[length++] = '.';
+    buf[length++] = '0';
+    return length;
+}
+
+#if defined(__cpp_lib_to_chars)
+
+size_t formatShortest(const double number, char* const buf, const size_t size,
+                      const bool scientific) {
+    const auto res = scientific ? std::to_chars(buf, buf + size, number,
+                                                std::chars_format::scientific)
+                                : std::to_chars(buf, buf + size, number);
+    return static_cast<size_t>(res.ptr - buf);
+}
+
+#else
+
+size_t formatShortest(const double number, char* const buf, const size_t size,
+                      const bool scientific) {
+    assert(size >= REAL_BUF_SIZE);
+    static_cast<void>(size);
+    auto p = buf;
+    if (std::signbit(number)) {
+        *p++ = '-';
+    }
+    if (std::isnan(number) || std::isinf(number)) {
+        const char* const name = std::isnan(number) ? "nan" : "inf";
+        return static_cast<size_t>(std::copy_n(name, 3, p) - buf);
+    }
+
+    // the shortest digits as 0.d1d2d3... * 10^point, without the locale,
+    // with room for all those of an integer
+    std::array<char, 22> digits{'0'};
+    size_t count = 1;
+    int32_t point = 1;
+    if (number != 0) {
+        count = SimpleJson::Number::toShortest(std::fabs(number),
+                                               digits.data(), point);
+    }
+    const auto exponent = point - 1;
+    const auto exponentDigits = std::abs(exponent) >= 100 ? 3 : 2;
+    const auto scientificLength =
+        count + (count > 1 ? 1 : 0) + 2 + exponentDigits;
+
+    // like std::to_chars, the fixed form unless it is longer
+    const auto fixedLength =
+        point <= 0 ? count + 2 + static_cast<size_t>(-point)
+        : static_cast<size_t>(point) >= count
+            ? static_cast<size_t>(point)
+            : count + 1;
+    if (!scientific && fixedLength <= scientificLength) {
+        if (point <= 0) {
+            *p++ = '0';
+            *p++ = '.';
+            p = std::fill_n(p, -point, '0');
+            p = std::copy_n(digits.begin(), count, p);
+        } else if (static_cast<size_t>(point) >= count) {
+            // all the digits of an integer, like std::to_chars, not just
+            // the shortest ones padded with zeros
+            if (number != 0) {
+                count = SimpleJson::Number::toIntegral(std::fabs(number),
+                                                       digits.data());
+            }
+            p = std::copy_n(digits.begin(), count, p);
+        } else {
+            p = std::copy_n(digits.begin(), point, p);
+            *p++ = '.';
+            p = std::copy_n(digits.begin() + point, count - point, p);
+        }
+        return static_cast<size_t>(p - buf);
+    }
+
+    *p++ = digits[0];
+    if (count > 1) {
+        *p++ = '.';
+        p = std::copy_n(digits.begin() + 1, count - 1, p);
+    }
+    *p++ = 'e';
+    *p++ = exponent < 0 ? '-' : '+';
+    auto magnitude = std::abs(exponent);
+    for (auto place = exponentDigits == 3 ? 100 : 10; place > 0; place /= 10) {
+        *p++ = static_cast<char>('0' + magnitude / place);
+        magnitude %= place;
+    }
+    return static_cast<size_t>(p - buf);
+}
+
+#endif
+
+}  // namespace
@@ -0,0 +1,136 @@
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "TestHelper.h"
+#include "gtest/gtest.h"
+#include "simplejson/Lazy.h"
+#include "simplejson/Reader.h"
+
+namespace SimpleJson {
+
+namespace {
+
+const std::string DOCUMENT = R"( {
+    "skipped": {"a": [1, "]}", {"b": "\"{["}], "c": null},
+    "name": "lazy",
+    "escaped": "tab\t",
+    "numbers": [0, -1, 18446744073709551615, 0.5, 1e2],
+    "flags": [true, false, null],
+    "nested": {"list": [[], {}, {"deep": "value"}]}
+} )";
+
+// the document is not copied, so a temporary one is refused
+static_assert(!std::is_constructible_v<LazyDocument, std::string>);
+static_assert(std::is_constructible_v<LazyDocument, const std::string&>);
+
+}  // namespace
+
+TEST(LazyTest, Navigate) {
+    LazyDocument doc(DOCUMENT);
+    EXPECT_EQ(ValueType::Object, doc.root().type());
+    EXPECT_EQ("lazy", doc["name"].asString());
+    EXPECT_EQ("tab\t", doc["escaped"].asString());
+    EXPECT_EQ("value", doc["nested"]["list"][2]["deep"].asString());
+    EXPECT_EQ(ValueType::Array, doc["nested"]["list"][0].type());
+    EXPECT_EQ(ValueType::Object, doc["nested"]["list"][1].type());
+    EXPECT_EQ("\"{[", doc["skipped"]["a"][2]["b"].asString());
+    EXPECT_TRUE(doc["skipped"]["c"].isNull());
+}
+
+TEST(LazyTest, ReadScalars) {
+    LazyDocument doc(DOCUMENT);
+    const auto numbers = doc["numbers"];
+    EXPECT_EQ(0, numbers[0].asInteger());
+    EXPECT_EQ(-1, numbers[1].asInteger());
+    EXPECT_EQ(ValueType::UInteger, numbers[2].type());
+    EXPECT_EQ(18446744073709551615ULL, numbers[2].asUInteger());
+    EXPECT_EQ(ValueType::Real, numbers[3].type());
+    EXPECT_EQ(0.5, numbers[3].asReal());
+    EXPECT_EQ(100.0, numbers[4].asReal());
+    EXPECT_TRUE(doc["flags"][0].asBool());
+    EXPECT_FALSE(doc["flags"][1].asBool());
+    EXPECT_EQ(ValueType::Null, doc["flags"][2].type());
+}
+
+TEST(LazyTest, RepeatedKey) {
+    // the last one, as parse keeps it
+    const std::string document = R"({"id": 1, "n\u0061me": "a", "id": 2,
+                                      "name": "b", "tail": [1, 2]})";
+    LazyDocument doc(document);
+    EXPECT_EQ(2, doc["id"].asInteger());
+    EXPECT_EQ("b", doc["name"].asString());
+
+    Reader reader;
+    Value expected;
+    ASSERT_TRUE(reader.parse(document, expected));
+    EXPECT_EQ(expected["id"], doc["id"].toValue());
+    EXPECT_EQ(expected["name"], doc["name"].toValue());
+
+    // a member that is found still needs the object to close
+    const std::string unclosed = R"({"id": 1, "other": 2)";
+    LazyDocument truncated(unclosed);
+    EXPECT_FALSE(truncated["id"].good());
+    EXPECT_EQ(ParseResult::MissCurlyBracket, truncated["id"].result());
+}
+
+TEST(LazyTest, ToValue) {
+    LazyDocument doc(DOCUMENT);
+    Reader reader;
+    Value expected;
+    ASSERT_TRUE(reader.parse(DOCUMENT, expected));
+    EXPECT_EQ(expected, doc.root().toValue());
+    EXPECT_EQ(expected["nested"], doc["nested"].toValue());
+}
+
+TEST(LazyTest, Missing) {
+    LazyDocument doc(DOCUMENT);
+    for (const auto& value :
+         {doc["none"], doc["numbers"][5], doc["name"]["x"], doc["name"][0],
+          doc["none"]["x"], doc[0], doc["nested"]["list"][1]["x"]}) {
+        EXPECT_FALSE(value.good());
+        EXPECT_EQ(ParseResult::Ok, value.result());
+        EXPECT_THROW((void)value.type(), std::out_of_range);
+        EXPECT_THROW((void)value.toValue(), std::out_of_range);
+    }
+}
+
+TEST(LazyTest, ScanErrors) {
+    const auto expectError = [](const ParseResult expected,
+                                const std::string& json) {
+        LazyDocument doc(json);
+        const auto value = doc["b"];
+        EXPECT_FALSE(value.good()) << json;
+        EXPECT_EQ(expected, value.result()) << json;
+        // kept by values navigated to from it
+        EXPECT_EQ(expected, value["c"][1].result()) << json;
+        EXPECT_THROW((void)value.asInteger(), std::out_of_range) << json;
+    };
+    expectError(ParseResult::MissCurlyBracket, R"({"a":1)");
+    expectError(ParseResult::MissCurlyBracket, R"({"a":{"c":[})");
+    expectError(ParseResult::MissSquareBracket, R"({"a":[1,2)");
+    expectError(ParseResult::MissQuotationMark, R"({"a":"abc)");
+    expectError(ParseResult::MissQuotationMark, R"({"a":"abc\)");
+    expectError(ParseResult::InvalidStringChar, "{\"a\":\"\x01\"}");
+    expectError(ParseResult::MissComma, R"({"a":1 "b":2})");
+    expectError(ParseResult::MissColon, R"({"a" 1,"b":2})");
+    expectError(ParseResult::MissKey, R"({"a":1,b:2})");
+    expectError(ParseResult::InvalidValue, R"({"a":,"b":2})");
+    expectError(ParseResult::ExpectValue, R"({"a":)");
+    expectError(ParseResult::InvalidUnicodeHex, R"({"\u00x":1,"b":2})");
+
+    LazyDocument empty(" ");
+    EXPECT_EQ(ParseResult::ExpectValue, empty.root().result());
+}
+
+TEST(LazyTest, ReadErrors) {
+    // values read are validated in full, those passed over are not
+    LazyDocument doc(R"({"a":[1,"\x"],"b":tru,"c":[1,],"d":2})");
+    EXPECT_EQ(2, doc["d"].asInteger());
+    EXPECT_THROW((void)doc["a"].toValue(), std::invalid_argument);
+    EXPECT_THROW((void)doc["b"].asBool(), std::invalid_argument);
+    EXPECT_THROW((void)doc["c"].toValue(), std::invalid_argument);
+    EXPECT_EQ(1, doc["c"][0].asInteger());
+}
+
+}  // namespace SimpleJson
@@ -0,0 +1,337 @@
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Number.h"
+#include "TestHelper.h"
+#include "gtest/gtest.h"
+
+namespace SimpleJson::Number {
+
+namespace {
+
+constexpr size_t RANDOM_COUNT = 100'000;
+// random reals also converted by the slow path alone, one in so many
+constexpr size_t SLOW_PATH_SAMPLING = 8;
+
+std::string format(const char* const spec, const double value) {
+    std::array<char, 64> buf{};
+    std::snprintf(buf.data(), buf.size(), spec, value);
+    return buf.data();
+}
+
+// a real must convert to `expected`, by toReal and by its slow path alone
+void expectReal(const std::string& text, const double expected,
+                const bool slowPath = true) {
+    const auto number = scan(text.c_str());
+    ASSERT_EQ(Type::Real, number.type) << text;
+    ASSERT_EQ(text.c_str() + text.size(), number.end) << text;
+
+    for (const auto convert : {&toReal, &toRealDecimal}) {
+        if (convert == &toRealDecimal && !slowPath) {
+            break;
+        }
+        Real actual = 0;
+        const auto res = convert(text.c_str(), number, actual);
+        if (std::isinf(expected)) {
+            EXPECT_EQ(ParseResult::NumberOverflow, res) << text;
+            continue;
+        }
+        ASSERT_EQ(ParseResult::Ok, res) << text;
+
+        // bitwise, so that the sign of zero counts
+        EXPECT_EQ(0, std::memcmp(&expected, &actual, sizeof(actual)))
+            << text << ": " << format("%.17g", expected) << " expected, "
+            << format("%.17g", actual) << " actual";
+    }
+}
+
+// a real must convert to the correctly rounded double, as strtod does
+void expectReal(const std::string& text, const bool slowPath = true) {
+    if (scan(text.c_str()).type == Type::Integer) {
+        // printed without a fraction or an exponent
+        return;
+    }
+    expectReal(text, std::strtod(text.c_str(), nullptr), slowPath);
+}
+
+// the shortest digits of a real must read back the same, and be those of
+// std::to_chars where there is one
+void expectShortest(const double value) {
+    std::array<char, 17> digits{};
+    int32_t point = 0;
+    const auto count = toShortest(value, digits.data(), point);
+    ASSERT_GT(count, 0U);
+    ASSERT_LE(count, digits.size());
+    const std::string text(digits.data(), count);
+    EXPECT_NE('0', text.back()) << text;
+
+    const auto printed = "0." + text + 'e' + std::to_string(point);
+    EXPECT_EQ(value, std::strtod(printed.c_str(), nullptr))
+        << printed << ": " << format("%.17g", value) << " expected";
+
+#if defined(__cpp_lib_to_chars)
+    std::array<char, 32> buf{};
+    const auto res = std::to_chars(buf.data(), buf.data() + buf.size(), value,
+                                   std::chars_format::scientific);
+    const std::string reference(buf.data(), res.ptr);
+    const auto e = reference.find('e');
+    auto expected = reference.substr(0, e);
+    expected.erase(std::remove(expected.begin(), expected.end(), '.'),
+                   expected.end());
+    EXPECT_EQ(expected, text) << reference;
+    EXPECT_EQ(std::stoi(reference.substr(e + 1)) + 1, point) << reference;
+#endif
+}
+
+// all the digits of an integral real, as std::to_chars has them
+void expectIntegral(const double value) {
+    std::array<char, 22> digits{};
+    const auto count = toIntegral(value, digits.data());
+    const std::string text(digits.data(), count);
+    EXPECT_EQ(format("%.0f", value), text);
+}
+
+// halfway between 1 and the next double
+const std::string HALFWAY =
+    "1.00000000000000011102230246251565404236316680908203125";
+
+// reals with more digits than the mantissa holds, which only the slow path
+// converts: halfway cases and their neighbors, also past the digits it
+// keeps, where dropped digits break the tie
+const std::vector<std::string> SLOW_PATH_REALS = {
+    HALFWAY,
+    "1.00000000000000011102230246251565404236316680908203124",
+    "1.00000000000000011102230246251565404236316680908203126",
+    // halfway between 1 + 2^-52 and 1 + 2^-51, ties to even rounds up
+    "1.00000000000000033306690738754696212708950042724609375",
+    HALFWAY + std::string(800, '0'),
+    HALFWAY + std::string(800, '0') + "1",
+    "9007199254740993.000000000000000000000000000000000001",
+    "9007199254740992.999999999999999999999999999999999999",
+    "2.4703282292062327208828439643411068618252990130716238221279284125e-324",
+    "2.4703282292062327208828439643411068618252990130716238221279284126e-324",
+    "1.7976931348623158079372897140530341507993413271003782693617377898e308",
+    "1.7976931348623158079372897140530341507993413271003782693617377899e308",
+    "0." + std::string(400, '0') + "12345678901234567890123e400",
+    std::string(400, '9') + ".5e-400",
+};
+
+}  // namespace
+
+TEST(NumberTest, ScanInteger) {
+    const auto number = scan("-1234567890123456789,");
+    EXPECT_EQ(Type::Integer, number.type);
+    EXPECT_TRUE(number.negative);
+    EXPECT_EQ(1234567890123456789U, number.mantissa);
+    EXPECT_FALSE(number.truncated);
+    EXPECT_EQ(',', *number.end);
+
+    EXPECT_FALSE(scan("18446744073709551615").truncated);
+    EXPECT_TRUE(scan("18446744073709551616").truncated);
+    EXPECT_TRUE(scan("100000000000000000000").truncated);
+}
+
+TEST(NumberTest, ConvertInteger) {
+    // an UInteger only above the Integer range
+    auto number = scan("9223372036854775807");
+    ASSERT_EQ(Type::Integer, number.type);
+    Integer integer = 0;
+    EXPECT_EQ(ParseResult::Ok, toInteger(number, integer));
+    EXPECT_EQ(std::numeric_limits<Integer>::max(), integer);
+
+    number = scan("9223372036854775808");
+    ASSERT_EQ(Type::UInteger, number.type);
+    UInteger uinteger = 0;
+    EXPECT_EQ(ParseResult::Ok, toUInteger(number, uinteger));
+    EXPECT_EQ(9223372036854775808U, uinteger);
+
+    number = scan("-9223372036854775808");
+    ASSERT_EQ(Type::Integer, number.type);
+    EXPECT_EQ(ParseResult::Ok, toInteger(number, integer));
+    EXPECT_EQ(std::numeric_limits<Integer>::min(), integer);
+
+    number = scan("-9223372036854775809");
+    ASSERT_EQ(Type::Integer, number.type);
+    EXPECT_EQ(ParseResult::NumberOverflow, toInteger(number, integer));
+    number = scan("18446744073709551616");
+    ASSERT_EQ(Type::UInteger, number.type);
+    EXPECT_EQ(ParseResult::NumberOverflow, toUInteger(number, uinteger));
+}
+
+TEST(NumberTest, ScanReal) {
+    auto number = scan("12.5e-3]");
+    EXPECT_EQ(Type::Real, number.type);
+    EXPECT_FALSE(number.negative);
+    EXPECT_EQ(125, number.mantissa);
+    EXPECT_EQ(-4, number.exponent);
+    EXPECT_EQ(']', *number.end);
+
+    // zeros dropped past the range of the mantissa are exact
+    number = scan("0.1000000000000000000000000000000");
+    EXPECT_EQ(Type::Real, number.type);
+    EXPECT_FALSE(number.truncated);
+    number = scan("0.1000000000000000000000000000001");
+    EXPECT_TRUE(number.truncated);
+
+    EXPECT_EQ(Type::Nan, scan("1.").type);
+    EXPECT_EQ(Type::Nan, scan("1e").type);
+    EXPECT_EQ(Type::Nan, scan("1e+").type);
+    EXPECT_EQ(Type::Nan, scan("-").type);
+    EXPECT_EQ(Type::Nan, scan(".5").type);
+}
+
+TEST(NumberTest, RealEdgeCases) {
+    for (const auto* const text : {
+             "0.0", "-0.0", "0e999999", "-0e-999999", "1e-999999",
+             "1e999999", "1e308", "1e309", "1e-324", "1e-323",
+             // min. subnormal, and around half of it
+             "4.9406564584124654e-324", "2.4703282292062327e-324",
+             "2.4703282292062328e-324",
+             // max. subnormal and min. normal
+             "2.2250738585072009e-308", "2.2250738585072011e-308",
+             "2.2250738585072014e-308",
+             // max. double, and around its rounding boundary to infinity
+             "1.7976931348623157e308", "1.7976931348623158e308",
+             "1.7976931348623159e308",
+             // 2^53 + 1 is halfway, ties to even
+             "9007199254740993.0", "9007199254740995.0",
+             "9007199254740993.000000000000000000001",
+             // exact powers of ten, and past the exact ones
+             "1e22", "1e23", "1e-22", "1e-23",
+             // more than 19 significant digits
+             "3.14159265358979323846264338327950288",
+             "123456789012345678901234567890.5",
+             "0.000000000000000000000000000000000000000000001",
+             "7.2057594037927933e16", "5e-324", "1.5e-323",
+         }) {
+        expectReal(text);
+    }
+}
+
+TEST(NumberTest, RealSlowPath) {
+    for (const auto& text : SLOW_PATH_REALS) {
+        EXPECT_TRUE(scan(text.c_str()).truncated) << text;
+        expectReal(text);
+    }
+}
+
+TEST(NumberTest, RealLocale) {
+    // strtod is the reference, in the C locale
+    std::vector<double> expected;
+    for (const auto& text : SLOW_PATH_REALS) {
+        expected.push_back(std::strtod(text.c_str(), nullptr));
+    }
+
+    // where strtod would stop at the '.' of a decimal comma
+    const std::string previous = std::setlocale(LC_NUMERIC, nullptr);
+    bool comma = false;
+    for (const auto* const name : {"de_DE.UTF-8", "de_DE.utf8", "de_DE",
+                                   "fr_FR.UTF-8", "fr_FR.utf8", "fr_FR"}) {
+        if (std::setlocale(LC_NUMERIC, name) != nullptr &&
+            std::strcmp(std::localeconv()->decimal_point, ",") == 0) {
+            comma = true;
+            break;
+        }
+    }
+    if (!comma) {
+        std::setlocale(LC_NUMERIC, previous.c_str());
+        GTEST_SKIP() << "no locale with a decimal comma";
+    }
+    for (size_t i = 0; i < SLOW_PATH_REALS.size(); ++i) {
+        expectReal(SLOW_PATH_REALS[i], expected[i]);
+    }
+    expectReal("0.1", 0.1);
+    expectReal("-2.5e-3", -2.5e-3);
+    std::setlocale(LC_NUMERIC, previous.c_str());
+}
+
+TEST(NumberTest, RealRoundtrip) {
+    // random doubles of all magnitudes print and parse back exactly
+    std::mt19937_64 random(42);
+    for (size_t i = 0; i < RANDOM_COUNT; ++i) {
+        uint64_t bits = random();
+        double value = 0;
+        std::memcpy(&value, &bits, sizeof(value));
+        if (!std::isfinite(value)) {
+            continue;
+        }
+
+        const auto text = format("%.17g", value);
+        const auto number = scan(text.c_str());
+        if (number.type != Type::Real) {
+            continue;
+        }
+        Real parsed = 0;
+        ASSERT_EQ(ParseResult::Ok, toReal(text.c_str(), number, parsed));
+        EXPECT_EQ(value, parsed) << text;
+
+        // shorter forms are not exact, but must round like strtod
+        const bool slowPath = i % SLOW_PATH_SAMPLING == 0;
+        expectReal(format("%.15g", value), slowPath);
+        expectReal(format("%.6e", value), slowPath);
+    }
+}
+
+TEST(NumberTest, Shortest) {
+    for (const auto value : {
+             1.0, 0.1, 0.3, 2.0 / 3, 5e-324, 1e-323,
+             2.2250738585072009e-308, 2.2250738585072014e-308,
+             1.7976931348623157e308, 1e22, 1e23, 9007199254740993.0,
+             9.5, 9.96, 123456789012345680.0, 0.000001, 1e21, 1e-7,
+         }) {
+        expectShortest(value);
+    }
+
+    // random doubles of all magnitudes
+    std::mt19937_64 random(3);
+    for (size_t i = 0; i < RANDOM_COUNT / SLOW_PATH_SAMPLING; ++i) {
+        uint64_t bits = random() >> 1;
+        double value = 0;
+        std::memcpy(&value, &bits, sizeof(value));
+        if (std::isfinite(value) && value > 0) {
+            expectShortest(value);
+        }
+        const auto integral = std::floor(std::ldexp(
+            static_cast<double>(random() >> 11), -static_cast<int>(i % 64)));
+        if (integral > 0) {
+            expectIntegral(integral * (i % 2 == 0 ? 1 : 1e6));
+        }
+    }
+    for (const auto value : {1.0, 9.0, 1e21, 9.999999999999998e21}) {
+        expectIntegral(value);
+    }
+}
+
+TEST(NumberTest, RealRandomDigits) {
+    // random digit strings of any length and exponent round like strtod
+    std::mt19937_64 random(7);
+    std::uniform_int_distribution<int> digitCount(1, 25);
+    std::uniform_int_distribution<int> digit(0, 9);
+    std::uniform_int_distribution<int> exponent(-360, 330);
+    for (size_t i = 0; i < RANDOM_COUNT; ++i) {
+        std::string text = random() % 2 == 0 ? "" : "-";
+        const auto count = digitCount(random);
+        const auto point = static_cast<int>(random() % count);
+        text += static_cast<char>('1' + digit(random) % 9);
+        for (int j = 1; j < count; ++j) {
+            if (j == point) {
+                text += '.';
+            }
+            text += static_cast<char>('0' + digit(random));
+        }
+        text += 'e' + std::to_string(exponent(random));
+        expectReal(text, i % SLOW_PATH_SAMPLING == 0);
+    }
+}
+
+}  // namespace SimpleJson::Number
@@ -0,0 +1,56 @@
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "Parallel.h"
+#include "gtest/gtest.h"
+
+namespace SimpleJson {
+
+TEST(ParallelTest, RunEachTask) {
+    for (const unsigned threadCount : {1U, 2U, 4U}) {
+        std::vector<int> runs(100);
+        forEachParallel(runs.size(), threadCount,
+                        [&](const size_t i) { ++runs[i]; });
+        EXPECT_EQ(std::vector<int>(100, 1), runs);
+    }
+    forEachParallel(0, 4, [](size_t) { FAIL(); });
+}
+
+TEST(ParallelTest, RethrowOnCaller) {
+    // the tasks left are dropped
+    size_t runs = 0;
+    const auto task = [&](const size_t i) {
+        ++runs;
+        if (i == 3) {
+            throw std::runtime_error("task");
+        }
+    };
+    EXPECT_THROW(forEachParallel(10, 1, task), std::runtime_error);
+    EXPECT_EQ(4, runs);
+}
+
+TEST(ParallelTest, RethrowFromWorker) {
+    const auto caller = std::this_thread::get_id();
+    std::atomic<size_t> started{0};
+    // each task waits for the other, so each thread runs one of them
+    const auto task = [&](size_t) {
+        ++started;
+        while (started < 2) {
+            std::this_thread::yield();
+        }
+        if (std::this_thread::get_id() != caller) {
+            throw std::runtime_error("worker");
+        }
+    };
+    try {
+        forEachParallel(2, 2, task);
+        ADD_FAILURE() << "nothing thrown";
+    } catch (const std::runtime_error& e) {
+        EXPECT_STREQ("worker", e.what());
+    }
+}
+
+}  // namespace SimpleJson
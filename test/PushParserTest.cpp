@@ -0,0 +1,189 @@
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "TestHelper.h"
+#include "gtest/gtest.h"
+#include "simplejson/PushParser.h"
+#include "simplejson/Reader.h"
+
+namespace SimpleJson {
+
+namespace {
+
+const std::vector<std::string> DOCUMENTS = {
+    // valid
+    "null",
+    " true ",
+    "false",
+    "0",
+    "-12.5e+3",
+    "18446744073709551615",
+    "-9223372036854775808",
+    R"("")",
+    R"("a\"b\\c\/d\b\f\n\r\t")",
+    R"("$¢€𝄞")",
+    "[]",
+    " [ 1 , [ 2 , [ ] ] , { } ] ",
+    R"({"a":{"b":[true,false,null]},"cA":"d","a":1})",
+    R"({ "number" : 1.5e-3 , "list" : [ "x" , -0 , 1E2 ] })",
+    // malformed
+    "",
+    " \t\n ",
+    "nul",
+    "tru e",
+    "?",
+    "1 2",
+    "[1]]",
+    "01",
+    "-",
+    "1.",
+    "1e",
+    "1e400",
+    R"("abc)",
+    R"("abc\)",
+    R"("\x")",
+    R"("\u00x1")",
+    R"("\uD834")",
+    R"("\uD834A")",
+    "\"a\x01b\"",
+    "[1,]",
+    "[1 2]",
+    "[1,2",
+    "[",
+    "[1x]",
+    R"({"a":1,})",
+    R"({"a" 1})",
+    R"({"a":})",
+    R"({"a":1 "b":2})",
+    R"({a:1})",
+    R"({"a":1)",
+    R"({"a")",
+    "{",
+    R"({"a":[1,2})",
+    R"({"a":"b"]})",
+    std::string("[1,\0]", 6),
+    std::string("\"a\0\"", 4),
+};
+
+// records the events of a document, to compare
+struct RecordingHandler {
+    void onNull() { events += "null\n"; }
+    void onBool(const Bool val) { events += val ? "true\n" : "false\n"; }
+    void onInteger(const Integer val) {
+        events += "integer " + std::to_string(val) + "\n";
+    }
+    void onUInteger(const UInteger val) {
+        events += "uinteger " + std::to_string(val) + "\n";
+    }
+    void onReal(const Real val) {
+        events += "real " + std::to_string(val) + "\n";
+    }
+    void onString(const std::string_view str) {
+        events += "string " + std::string(str) + "\n";
+    }
+    void onStartArray() { events += "[\n"; }
+    void onEndArray(const size_t size) {
+        events += "] " + std::to_string(size) + "\n";
+    }
+    void onStartObject() { events += "{\n"; }
+    void onKey(const std::string_view key) {
+        events += "key " + std::string(key) + "\n";
+    }
+    void onEndObject(const size_t size) {
+        events += "} " + std::to_string(size) + "\n";
+    }
+
+    std::string events;
+};
+
+/// feed `document` in chunks of `size` chars
+bool feedChunks(PushParser& parser, const std::string_view document,
+                const size_t size) {
+    for (size_t pos = 0; pos < document.size(); pos += size) {
+        parser.feed(document.substr(pos, size));
+    }
+    return parser.finish();
+}
+
+}  // namespace
+
+TEST(PushParserTest, SplitAnywhere) {
+    Reader reader;
+    for (const auto& document : DOCUMENTS) {
+        Value expected;
+        const bool good = reader.parse(document.data(), document.size(),
+                                       expected);
+        for (size_t split = 0; split <= document.size(); ++split) {
+            Value value(true);
+            PushParser parser(value);
+            parser.feed(std::string_view(document).substr(0, split));
+            parser.feed(std::string_view(document).substr(split));
+            EXPECT_EQ(good, parser.finish()) << document << " @" << split;
+            EXPECT_EQ(reader.result(), parser.result())
+                << document << " @" << split;
+            EXPECT_EQ(expected, value) << document << " @" << split;
+        }
+    }
+}
+
+TEST(PushParserTest, CharByChar) {
+    Reader reader;
+    for (const auto& document : DOCUMENTS) {
+        Value expected;
+        reader.parse(document.data(), document.size(), expected);
+        Value value(true);
+        PushParser parser(value);
+        feedChunks(parser, document, 1);
+        EXPECT_EQ(reader.result(), parser.result()) << document;
+        EXPECT_EQ(expected, value) << document;
+    }
+}
+
+TEST(PushParserTest, Events) {
+    Reader reader;
+    for (const auto& document : DOCUMENTS) {
+        RecordingHandler expected;
+        if (!reader.parse(document.data(), document.size(), expected)) {
+            continue;
+        }
+        RecordingHandler handler;
+        PushParser parser(handler);
+        EXPECT_TRUE(feedChunks(parser, document, 3)) << document;
+        EXPECT_EQ(expected.events, handler.events) << document;
+    }
+}
+
+TEST(PushParserTest, DepthExceeded) {
+    // the depth of Reader::parse, in chunks as the brackets arrive
+    const auto depth = Reader::DEFAULT_MAX_DEPTH;
+    Value value;
+    PushParser parser(value);
+    EXPECT_TRUE(feedChunks(parser,
+                           std::string(depth, '[') + std::string(depth, ']'),
+                           7));
+    EXPECT_FALSE(feedChunks(parser, std::string(depth + 1, '['), 7));
+    EXPECT_EQ(ParseResult::DepthExceeded, parser.result());
+}
+
+TEST(PushParserTest, NextDocument) {
+    Value value;
+    PushParser parser(value);
+    EXPECT_TRUE(parser.feed("[1,"));
+    EXPECT_FALSE(parser.feed("x]"));
+    EXPECT_EQ(ParseResult::InvalidValue, parser.result());
+    EXPECT_FALSE(parser.feed("2]"));
+    EXPECT_FALSE(parser.finish());
+    EXPECT_EQ(ParseResult::InvalidValue, parser.result());
+    EXPECT_TRUE(value.isNull());
+
+    // starts over after finish()
+    EXPECT_TRUE(parser.feed(R"({"a")"));
+    EXPECT_TRUE(parser.feed(R"(:2})"));
+    EXPECT_TRUE(parser.finish());
+    EXPECT_EQ(2, value["a"].asInteger());
+    EXPECT_FALSE(parser.finish());
+    EXPECT_EQ(ParseResult::ExpectValue, parser.result());
+}
+
+}  // namespace SimpleJson
@@ -1,9 +1,20 @@
 #include "ReaderTest.h"
 
 #include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 #include "TestHelper.h"
 #include "gtest/gtest.h"
+#include "simplejson/KeyTable.h"
 #include "simplejson/Reader.h"
 
 namespace SimpleJson {
@@ -36,6 +47,136 @@ TEST_F(ReaderTest, ParseRootNotSingular) {
     EXPECT_PARSE_ERROR(ParseResult::RootNotSingular, "true null");
 }
 
+TEST_F(ReaderTest, ParseLength) {
+    EXPECT_PARSE_BOOL(true, std::string_view("truex", 4));
+    EXPECT_PARSE_STRING("abc", std::string_view("\"abc\"\"", 5));
+    EXPECT_PARSE_ERROR(ParseResult::MissQuotationMark,
+                       std::string_view("\"abc\"", 4));
+    EXPECT_PARSE_ERROR(ParseResult::MissSquareBracket,
+                       std::string_view("[1, 2]", 5));
+    EXPECT_PARSE_ERROR(ParseResult::ExpectValue, std::string_view());
+
+    Value value;
+    EXPECT_TRUE(reader.parse("[1, 2] trailing", 6, value));
+    EXPECT_EQ(2, value.size());
+    EXPECT_FALSE(reader.parse(nullptr, 0, value));
+    EXPECT_EQ(ParseResult::ExpectValue, reader.result());
+}
+
+TEST_F(ReaderTest, ParseBuffer) {
+    // stale chars past the document are cut off by a NUL
+    char number[] = "12345";
+    Value value;
+    EXPECT_TRUE(reader.parse(number, 2, sizeof(number), value));
+    EXPECT_EQ(12, value.asInteger());
+    EXPECT_EQ(0, number[2]);
+    char array[] = R"(["abc", 12]345)";
+    EXPECT_TRUE(reader.parse(array, 11, sizeof(array), value));
+    EXPECT_EQ(12, value[1].asInteger());
+
+    // strings are views into the buffer, which is not copied
+    struct StringData : BaseHandler {
+        void onString(const std::string_view str) { data = str.data(); }
+        const char* data = nullptr;
+    } handler;
+    char string[] = R"(["abc"]x)";
+    EXPECT_TRUE(reader.parse(string, 7, sizeof(string), handler));
+    EXPECT_EQ(string + 2, handler.data);
+
+    // also with no room past it
+    char full[] = {'"', 'a', '"'};
+    EXPECT_TRUE(reader.parse(full, sizeof(full), sizeof(full), handler));
+    EXPECT_EQ(full + 1, handler.data);
+    EXPECT_FALSE(reader.parse(full, 2, sizeof(full), value));
+    EXPECT_EQ(ParseResult::MissQuotationMark, reader.result());
+    EXPECT_FALSE(reader.parse(nullptr, 0, 0, value));
+    EXPECT_EQ(ParseResult::ExpectValue, reader.result());
+}
+
+TEST_F(ReaderTest, ParseUnterminated) {
+    // the chars past the end must not be read: once followed by chars that
+    // would change the result, once at the very end of an allocation
+    const std::vector<std::string> docs = {
+        "", " ", "123", "-1.5e3 ", "tru", "[1,2", "[1,2 ", "[1] ", "[[]]x",
+        R"("abc)", R"("ab\)", R"("\u12)", R"("\uD800)", R"("\uD800\u)",
+        R"("\uD800\uDC0)", R"(["a",1.5e3,true,null])", R"({"a":"b"})",
+        R"({"a")", R"({"a":)", R"({"a":1,"b":[{"c":"d\"e"}]} )"};
+    for (const auto& doc : docs) {
+        Value expected;
+        const bool good = reader.parse(doc, expected);
+        const auto result = reader.result();
+
+        const auto followed = doc + R"(0"]}\ul)";
+        Value value;
+        EXPECT_EQ(good, reader.parse(followed.data(), doc.size(), value))
+            << doc;
+        EXPECT_EQ(result, reader.result()) << doc;
+        EXPECT_EQ(expected, value) << doc;
+
+        const auto exact = std::make_unique<char[]>(doc.size());
+        doc.copy(exact.get(), doc.size());
+        EXPECT_EQ(good, reader.parse(exact.get(), doc.size(), value)) << doc;
+        EXPECT_EQ(result, reader.result()) << doc;
+        EXPECT_EQ(expected, value) << doc;
+    }
+
+    // only the tail is copied, the strings before it are views in place
+    struct StringData : BaseHandler {
+        void onString(const std::string_view str) { data.push_back(str); }
+        std::vector<std::string_view> data;
+    } handler;
+    const std::string_view doc = R"(["abc", "d", 12] )";
+    EXPECT_TRUE(reader.parse(doc.data(), doc.size(), handler));
+    ASSERT_EQ(2, handler.data.size());
+    EXPECT_EQ(doc.data() + 2, handler.data[0].data());
+    EXPECT_EQ(doc.data() + 9, handler.data[1].data());
+}
+
+TEST_F(ReaderTest, ParseEmbeddedNul) {
+    using namespace std::string_literals;
+    EXPECT_PARSE_ERROR(ParseResult::RootNotSingular, "null\0"s);
+    EXPECT_PARSE_ERROR(ParseResult::InvalidValue, "\0null"s);
+    EXPECT_PARSE_ERROR(ParseResult::InvalidStringChar, "\"a\0b\""s);
+    EXPECT_PARSE_ERROR(ParseResult::MissComma, "[1\0]"s);
+    EXPECT_PARSE_ERROR(ParseResult::MissComma, "{\"a\":1\0}"s);
+
+    // a C string ends at the first NUL
+    EXPECT_PARSE_BOOL(true, "true\0x");
+}
+
+TEST_F(ReaderTest, ParseFile) {
+    const auto path = std::string("ReaderTest.ParseFile.json");
+    const auto writeFile = [&](const std::string& content) {
+        std::ofstream(path, std::ios::binary) << content;
+    };
+
+    Value value;
+    writeFile("{ \"a\" : [ 1, 2 ] }");
+    EXPECT_TRUE(reader.parseFile(path, value));
+    EXPECT_EQ(2, value["a"].size());
+
+    // sizes of common pages, the file ends right on a page boundary
+    for (const size_t size : {4096, 16384, 65536}) {
+        const auto text = std::string(size - 2, 'x');
+        writeFile("\"" + text + "\"");
+        EXPECT_TRUE(reader.parseFile(path, value));
+        EXPECT_EQ(text, value.asStringView());
+
+        writeFile("\"" + text + "x");
+        EXPECT_FALSE(reader.parseFile(path, value));
+        EXPECT_EQ(ParseResult::MissQuotationMark, reader.result());
+    }
+
+    writeFile("");
+    EXPECT_FALSE(reader.parseFile(path, value));
+    EXPECT_EQ(ParseResult::ExpectValue, reader.result());
+
+    std::remove(path.c_str());
+    EXPECT_FALSE(reader.parseFile(path, value));
+    EXPECT_EQ(ParseResult::InvalidFile, reader.result());
+    EXPECT_EQ(ValueType::Null, value.type());
+}
+
 TEST_F(ReaderTest, ParseBool) {
     EXPECT_PARSE_BOOL(true, "true");
     EXPECT_PARSE_BOOL(true, " true ");
@@ -43,6 +184,14 @@ TEST_F(ReaderTest, ParseBool) {
     EXPECT_PARSE_BOOL(false, "\tfalse\n");
 }
 
+TEST_F(ReaderTest, ParseLongWhitespace) {
+    const auto indent = std::string(40, ' ') + "\t\r\n" + std::string(40, ' ');
+    EXPECT_PARSE_BOOL(true, indent + "true" + indent);
+    EXPECT_PARSE_ERROR(ParseResult::ExpectValue, indent);
+    EXPECT_PARSE_ERROR(ParseResult::RootNotSingular,
+                       indent + "true" + indent + "x");
+}
+
 TEST_F(ReaderTest, ParseInteger) {
     EXPECT_PARSE_INTEGER(0, " 0");
     EXPECT_PARSE_INTEGER(0, "-0");
@@ -52,6 +201,14 @@ TEST_F(ReaderTest, ParseInteger) {
     EXPECT_PARSE_INTEGER(INT32_MIN, "-2147483648");
     EXPECT_PARSE_INTEGER(INT64_MAX, " 9223372036854775807");
     EXPECT_PARSE_INTEGER(INT64_MIN, "-9223372036854775808");
+    EXPECT_PARSE_INTEGER(1234567890123456789, "1234567890123456789");
+}
+
+TEST_F(ReaderTest, ParseUnsignedInteger) {
+    // only above the range of Integer
+    EXPECT_PARSE_UINTEGER(9223372036854775808ULL, " 9223372036854775808");
+    EXPECT_PARSE_UINTEGER(12345678901234567890ULL, "12345678901234567890");
+    EXPECT_PARSE_UINTEGER(UINT64_MAX, "18446744073709551615");
 }
 
 TEST_F(ReaderTest, ParseRealNumber) {
@@ -114,8 +271,12 @@ TEST_F(ReaderTest, ParseNumberInvalid) {
 }
 
 TEST_F(ReaderTest, ParseNumberOverflow) {
-    EXPECT_PARSE_ERROR(ParseResult::NumberOverflow, " 9223372036854775808");
+    EXPECT_PARSE_ERROR(ParseResult::NumberOverflow, " 18446744073709551616");
+    EXPECT_PARSE_ERROR(ParseResult::NumberOverflow, " 18446744073709551620");
+    EXPECT_PARSE_ERROR(ParseResult::NumberOverflow, " 99999999999999999999");
+    EXPECT_PARSE_ERROR(ParseResult::NumberOverflow, "100000000000000000000");
     EXPECT_PARSE_ERROR(ParseResult::NumberOverflow, "-9223372036854775809");
+    EXPECT_PARSE_ERROR(ParseResult::NumberOverflow, "-18446744073709551616");
 
     EXPECT_PARSE_ERROR(ParseResult::NumberOverflow, " 1e309");
     EXPECT_PARSE_ERROR(ParseResult::NumberOverflow, "-1e309");
@@ -130,6 +291,17 @@ TEST_F(ReaderTest, ParseString) {
                         R"("\" \\ \/ \b \f \n \r \t")");
 }
 
+TEST_F(ReaderTest, ParseStringLong) {
+    const auto text = std::string(100, 'x');
+    EXPECT_PARSE_STRING(text, "\"" + text + "\"");
+    EXPECT_PARSE_STRING(text + "\n" + text,
+                        "\"" + text + "\\n" + text + "\"");
+    EXPECT_PARSE_STRING("\t" + text + "\"", "\"\\t" + text + "\\\"\"");
+    EXPECT_PARSE_ERROR(ParseResult::MissQuotationMark, "\"" + text);
+    EXPECT_PARSE_ERROR(ParseResult::InvalidStringChar,
+                       "\"" + text + "\x01" + text + "\"");
+}
+
 TEST_F(ReaderTest, ParseStringMissQuotationMark) {
     EXPECT_PARSE_ERROR(ParseResult::MissQuotationMark, R"(")");
     EXPECT_PARSE_ERROR(ParseResult::MissQuotationMark, R"("abc)");
@@ -153,6 +325,16 @@ TEST_F(ReaderTest, ParseStringUnicode) {
 
     // Dollar sign U+0024
     EXPECT_PARSE_STRING("\x24", R"("\u0024")");
+    // Delete U+007F
+    EXPECT_PARSE_STRING("\x7F", R"("\u007F")");
+    // every 7-bit code point keeps all 7 bits, U+0040 to U+007F included
+    constexpr auto HEX_DIGITS = "0123456789ABCDEF";
+    for (unsigned c = 0; c < 0x80; ++c) {
+        const std::string doc = {'"', '\\', 'u', '0', '0',
+                                 HEX_DIGITS[c >> 4U], HEX_DIGITS[c & 0xFU],
+                                 '"'};
+        EXPECT_PARSE_STRING(std::string(1, static_cast<char>(c)), doc);
+    }
     // Cents sign U+00A2
     EXPECT_PARSE_STRING("\xC2\xA2", R"("\u00A2")");
     // Euro sign U+20AC
@@ -296,6 +478,312 @@ TEST_F(ReaderTest, ParseObject) {
     EXPECT_EQ(3, value["o"]["3"].asInteger());
 }
 
+TEST_F(ReaderTest, ParseIntoArena) {
+    const auto doc = R"({
+        "s" : "a string long enough to need an allocation" ,
+        "a" : [ 1 , "two" , [ 3 ] ] ,
+        "o" : { "key" : "value" , "nested" : { } }
+    })";
+
+    // nothing may come from the default resource
+    std::pmr::monotonic_buffer_resource arena;
+    auto* const previous =
+        std::pmr::set_default_resource(std::pmr::null_memory_resource());
+    Value value;
+    Reader arenaReader(&arena);
+    const bool ok = arenaReader.parse(doc, value);
+    std::pmr::set_default_resource(previous);
+
+    ASSERT_TRUE(ok);
+    Value expected;
+    ASSERT_TRUE(reader.parse(doc, expected));
+    EXPECT_EQ(expected, value);
+    EXPECT_EQ("value", value["o"]["key"].asStringView());
+}
+
+TEST_F(ReaderTest, ParseIndexed) {
+    // the same values and errors as by the grammar alone, also for tokens
+    // out of place that the second stage may meet before the grammar fails
+    std::string nested;
+    for (int i = 0; i < 40; ++i) {
+        nested += R"({"key\"\\": [ 1 , -2.5e3 , "\u20AC" , true ] , "n":)";
+    }
+    nested += "null" + std::string(40, '}');
+    const std::vector<std::string> docs = {
+        nested, " [ ] ", "{}", "0", "\"\"", " null ", R"([{"a":{}},[[]]])",
+        R"({"a" : "x\"y" , "b\\" : [ false , 1e2 ] })", "", " ", "[", "{",
+        "[1 2]", "[1x]", "[1,]", "[,1]", "{,}", R"({"a" 1})", R"({"a":1,})",
+        R"({"a":1 "b":2})", R"({a:1})", R"({"a"x:1})", "nullx", "null x",
+        "tru", R"("a""b")", R"("a"1)", R"(1"a")", R"(["a\"])", R"(["\x"])",
+        "\"abc", "[\"\x01\"]", "1e999", std::string("[1]\0", 4),
+        std::string("[1\0]", 4), nested.substr(1)};
+    for (const auto& doc : docs) {
+        Value expected;
+        const bool ok = reader.parse(doc, expected);
+        const auto result = reader.result();
+
+        auto value = Value(false);
+        EXPECT_EQ(ok, reader.parseIndexed(doc, value)) << doc;
+        EXPECT_EQ(result, reader.result()) << doc;
+        EXPECT_EQ(expected, value) << doc;
+    }
+}
+
+TEST_F(ReaderTest, ParseParallel) {
+    std::string records = "[";
+    for (int i = 0; i < 500; ++i) {
+        records += (i == 0 ? "" : " ,\n") + std::string(R"({"id":)") +
+                   std::to_string(i) + R"(,"tags":["a,]","b"],"n":{"x":[]}})";
+    }
+    records += "]";
+    // the same values and errors as parse, also where the elements found
+    // from the structural chars are out of place
+    const std::vector<std::string> docs = {
+        records, records + " ", " " + records, records + "]",
+        records.substr(0, records.size() - 1), records + "x",
+        records.substr(0, 5000) + "," + records.substr(5000),
+        records.substr(0, 5000) + "}" + records.substr(5000),
+        records.substr(0, 5000) + " 1 " + records.substr(5000),
+        records.substr(0, 5000) + "\"" + records.substr(5000), "[]",
+        " [ 1 ] ", "[1,]", "[,1]", "[1 2]", "[1}", "[{]}", "[[1],[2]]x",
+        std::string("[1,\0]", 5), std::string("[1]\0", 4), "{}", "1"};
+    for (const auto& doc : docs) {
+        Value expected;
+        const bool ok = reader.parse(doc, expected);
+        const auto result = reader.result();
+
+        for (const unsigned threads : {1U, 2U, 3U, 8U}) {
+            auto value = Value(false);
+            EXPECT_EQ(ok, reader.parseParallel(doc, value, threads)) << doc;
+            EXPECT_EQ(result, reader.result()) << doc;
+            EXPECT_EQ(expected, value) << doc;
+        }
+    }
+}
+
+namespace {
+
+// allocates from the default resource, noting if another thread than the
+// first one does, as an arena is not thread-safe
+class OneThreadResource : public std::pmr::memory_resource {
+public:
+    bool shared = false;
+
+private:
+    void* do_allocate(const size_t bytes, const size_t alignment) override {
+        const auto id = std::this_thread::get_id();
+        {
+            const std::lock_guard<std::mutex> lock(_mutex);
+            if (_owner == std::thread::id()) {
+                _owner = id;
+            }
+            shared = shared || id != _owner;
+        }
+        return std::pmr::get_default_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* const p, const size_t bytes,
+                       const size_t alignment) override {
+        std::pmr::get_default_resource()->deallocate(p, bytes, alignment);
+    }
+    [[nodiscard]] bool do_is_equal(
+        const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::mutex _mutex;
+    std::thread::id _owner;
+};
+
+}  // namespace
+
+TEST_F(ReaderTest, ParseParallelResource) {
+    std::string records = "[";
+    for (int i = 0; i < 500; ++i) {
+        records += (i == 0 ? "" : ",") + std::string(R"({"name":"record )") +
+                   std::to_string(i) + R"( with a long enough name"})";
+    }
+    records += "]";
+    Value expected;
+    ASSERT_TRUE(reader.parse(records, expected));
+
+    // any other resource than the default one is used on one thread
+    OneThreadResource resource;
+    Reader resourceReader(&resource);
+    Value value;
+    EXPECT_TRUE(resourceReader.parseParallel(records, value, 4));
+    EXPECT_EQ(expected, value);
+    EXPECT_FALSE(resource.shared);
+}
+
+TEST_F(ReaderTest, ParseProjected) {
+    const std::string doc = R"({
+        "header": {"tenant": "acme", "trace": [1, "]}", {"x": "\"{"}],
+                   "type": "order", "t\u0061g": 7, "a/b": 1, "m~n": 2},
+        "body": [1, "\x", tru, {"deep": [[[]]]}],
+        "items": [{"name": "a"}, 2, {"name": "c", "size": 3}],
+        "payload": {"id": 42, "id": 43}
+    })";
+    Value expected;
+    const auto project = [&](const std::vector<std::string_view>& pointers) {
+        Value value(true);
+        EXPECT_TRUE(reader.parseProjected(doc, pointers, value));
+        EXPECT_EQ(ParseResult::Ok, reader.result());
+        return value;
+    };
+
+    // skipped values are only matched, and the last of a repeated key wins
+    ASSERT_TRUE(reader.parse(
+        R"({"header":{"tenant":"acme","type":"order"},"payload":{"id":43}})",
+        expected));
+    EXPECT_EQ(expected,
+              project({"/header/tenant", "/header/type", "/payload/id"}));
+    ASSERT_TRUE(reader.parse(
+        R"({"header":{"tag":7,"a/b":1,"m~n":2},)"
+        R"("items":[null,null,{"name":"c"}]})",
+        expected));
+    EXPECT_EQ(expected, project({"/header/tag", "/header/a~1b", "/header/m~0n",
+                                 "/items/2/name", "/items/2/name"}));
+    ASSERT_TRUE(reader.parse(R"({"items":[{"name":"a"}]})", expected));
+    EXPECT_EQ(expected, project({"/items/0", "/items/0/name", "/items/-",
+                                 "/items/00", "/items/1/name"}));
+    ASSERT_TRUE(reader.parse(R"({"header":{"trace":[1,"]}"]}})", expected));
+    EXPECT_EQ(expected, project({"/header/trace/1", "/header/trace/0"}));
+
+    // missing values are left out
+    EXPECT_TRUE(project({"/none", "/header/tenant/x", "/items/9"}).isNull());
+    EXPECT_TRUE(project({}).isNull());
+
+    // as parse, a repeated key leaves only what its last member has
+    Value value;
+    const std::vector<std::string_view> ab = {"/a/b"};
+    EXPECT_TRUE(reader.parseProjected(R"({"a":{"b":1},"a":{"b":2}})", ab,
+                                      value));
+    EXPECT_EQ(2, value["a"]["b"].asInteger());
+    EXPECT_TRUE(reader.parseProjected(R"({"a":{"b":1},"a":{"c":2}})", ab,
+                                      value));
+    EXPECT_TRUE(value.isNull());
+    EXPECT_TRUE(reader.parseProjected(R"({"x":{"b":1},"a":{"b":1},"a":[]})",
+                                      {"/a/b", "/x/b"}, value));
+    ASSERT_TRUE(reader.parse(R"({"x":{"b":1}})", expected));
+    EXPECT_EQ(expected, value);
+
+    // the whole document is scanned, after all are found too
+    for (const auto* const text :
+         {R"({"a":{"b":1},"c":)", R"({"a":{"b":1},"c":[1,2,} garbage)",
+          R"({"a":{"b":1}} garbage)", R"({"a":{"b":1}}})"}) {
+        value = Value(true);
+        EXPECT_FALSE(reader.parseProjected(text, ab, value)) << text;
+        EXPECT_NE(ParseResult::Ok, reader.result()) << text;
+        EXPECT_TRUE(value.isNull()) << text;
+    }
+    EXPECT_FALSE(reader.parseProjected(R"({"a":{"b":1}} {})", ab, value));
+    EXPECT_EQ(ParseResult::RootNotSingular, reader.result());
+    EXPECT_FALSE(reader.parseProjected("[1, 2", {}, value));
+    EXPECT_EQ(ParseResult::MissSquareBracket, reader.result());
+
+    // the whole document
+    ASSERT_TRUE(reader.parse(R"([1,{"a":[]}])", expected));
+    EXPECT_TRUE(reader.parseProjected(R"( [1, {"a": []}] )", {""}, value));
+    EXPECT_EQ(expected, value);
+}
+
+TEST_F(ReaderTest, ParseProjectedErrors) {
+    const auto expectError = [&](const ParseResult expected,
+                                 const std::string& doc) {
+        auto value = Value(false);
+        EXPECT_FALSE(reader.parseProjected(doc, {"/a/b", "/c"}, value)) << doc;
+        EXPECT_EQ(expected, reader.result()) << doc;
+        EXPECT_TRUE(value.isNull()) << doc;
+    };
+    expectError(ParseResult::ExpectValue, " ");
+    expectError(ParseResult::MissColon, R"({"a" {"b":1}})");
+    expectError(ParseResult::MissKey, R"({"a":{b:1}})");
+    expectError(ParseResult::MissComma, R"({"x":1 "a":{"b":1}})");
+    expectError(ParseResult::InvalidValue, R"({"a":{"b":tru}})");
+    expectError(ParseResult::MissCurlyBracket, R"({"a":{"b":1})");
+    expectError(ParseResult::MissSquareBracket, R"({"a":{"b":1},"x":[1,2)");
+    expectError(ParseResult::MissQuotationMark, R"({"a":{"x":"b)");
+    expectError(ParseResult::InvalidUnicodeHex, R"({"\u00x":1})");
+
+    Value value;
+    EXPECT_THROW((void)reader.parseProjected("{}", {"a"}, value),
+                 std::invalid_argument);
+    EXPECT_THROW((void)reader.parseProjected("{}", {"/a~2"}, value),
+                 std::invalid_argument);
+}
+
+TEST_F(ReaderTest, ParseInsitu) {
+    auto doc = std::string(
+        R"({ "plain" : "abc" , "escaped" : [ "a\tb\u20AC" , "" ] })");
+    const auto inDoc = [&](const char* str) {
+        return str >= doc.data() && str < doc.data() + doc.size();
+    };
+
+    Value value;
+    ASSERT_TRUE(reader.parseInsitu(doc, value));
+    EXPECT_EQ("abc", value["plain"].asStringView());
+    EXPECT_TRUE(inDoc(value["plain"].asCString()));
+    EXPECT_EQ("a\tb\xE2\x82\xAC", value["escaped"][0].asStringView());
+    EXPECT_TRUE(inDoc(value["escaped"][0].asCString()));
+    EXPECT_TRUE(value["escaped"][1].asStringView().empty());
+
+    // copies refer to the document too
+    const auto copy = value;
+    EXPECT_EQ(value["plain"].asCString(), copy["plain"].asCString());
+
+    auto text = std::string("\"Hello\\nWorld\"");
+    ASSERT_TRUE(reader.parseInsitu(text.data(), value));
+    EXPECT_STREQ("Hello\nWorld", value.asCString());
+    EXPECT_EQ(text.data() + 1, value.asCString());
+
+    auto invalid = std::string(R"([ "abc" , "\x" ])");
+    EXPECT_FALSE(reader.parseInsitu(invalid, value));
+    EXPECT_EQ(ParseResult::InvalidStringEscape, reader.result());
+}
+
+TEST_F(ReaderTest, ParseInternKeys) {
+    KeyTable keyTable;
+    Reader interning(std::pmr::get_default_resource(), &keyTable);
+
+    Value value;
+    ASSERT_TRUE(interning.parse(
+        R"([ { "id" : 1 , "name" : "a" } , { "id" : 2 , "n\u0061me" : "b" } ,
+             { "id" : 3 , "id" : 4 } ])",
+        value));
+    ASSERT_EQ(3, value.size());
+    EXPECT_EQ(2, value[1]["id"].asInteger());
+    EXPECT_EQ("b", value[1]["name"].asStringView());
+    EXPECT_EQ(1, value[2].size());
+    EXPECT_EQ(4, value[2]["id"].asInteger());
+
+    // equal keys, escaped or not, share one copy
+    EXPECT_EQ(value[0].getMemberName(0).data(),
+              value[1].getMemberName(0).data());
+    EXPECT_EQ(value[0].getMemberName(1).data(),
+              value[1].getMemberName(1).data());
+    EXPECT_EQ(2, keyTable.size());
+    EXPECT_EQ(6, keyTable.lookups());
+    EXPECT_EQ(4, keyTable.hits());
+    EXPECT_DOUBLE_EQ(4.0 / 6.0, keyTable.hitRate());
+
+    // the table is shared by later documents
+    Value other;
+    ASSERT_TRUE(interning.parse(R"({ "name" : "c" })", other));
+    EXPECT_EQ(value[0].getMemberName(1).data(), other.getMemberName(0).data());
+    EXPECT_EQ(2, keyTable.size());
+
+    // and the values compare as usual
+    Value copied;
+    ASSERT_TRUE(reader.parse(R"({ "name" : "c" })", copied));
+    EXPECT_EQ(copied, other);
+
+    // interning only saves memory: other chars still find interned keys
+    const std::string name = "name";
+    EXPECT_TRUE(other.isMember(name));
+    EXPECT_EQ("c", other[name].asStringView());
+    EXPECT_FALSE(other.isMember("nam"));
+}
+
 TEST_F(ReaderTest, ParseObjectMissKey) {
     EXPECT_PARSE_ERROR(ParseResult::MissKey, "{:1,");
     EXPECT_PARSE_ERROR(ParseResult::MissKey, "{1:1,");
@@ -327,4 +815,173 @@ TEST_F(ReaderTest, ParseObjectInvalidValue) {
     EXPECT_PARSE_ERROR(ParseResult::MissQuotationMark, R"({"abc)");
 }
 
+namespace {
+
+// take apart a value nested as deep as its first elements and members go,
+// from the root down as destroying it would recurse; return the depth
+size_t releaseNested(Value& value) {
+    size_t depth = 0;
+    while ((value.isArray() || value.isObject()) && value.size() != 0) {
+        ++depth;
+        auto child = value.isArray()
+                         ? std::move(value[0])
+                         : value.removeMember(value.getMemberName(0));
+        value.swap(child);
+    }
+    return depth;
+}
+
+}  // namespace
+
+TEST_F(ReaderTest, ParseDepthExceeded) {
+    const auto nest = [](const size_t depth) {
+        std::string doc;
+        for (size_t i = 0; i < depth; ++i) {
+            doc += i % 2 == 0 ? "[" : R"({"a":)";
+        }
+        doc += "0";
+        for (size_t i = depth; i > 0; --i) {
+            doc += i % 2 == 1 ? "]" : "}";
+        }
+        return doc;
+    };
+    // the root counts as one
+    Value value;
+    EXPECT_TRUE(reader.parse(nest(Reader::DEFAULT_MAX_DEPTH), value));
+    EXPECT_PARSE_ERROR(ParseResult::DepthExceeded,
+                       nest(Reader::DEFAULT_MAX_DEPTH + 1));
+    EXPECT_PARSE_ERROR(ParseResult::DepthExceeded, std::string(100'000, '['));
+
+    reader.setMaxDepth(2);
+    EXPECT_TRUE(reader.parse(R"([{"a":1},[]])", value));
+    EXPECT_PARSE_ERROR(ParseResult::DepthExceeded, R"([{"a":[]}])");
+    EXPECT_PARSE_ERROR(ParseResult::DepthExceeded, "[[[1,2");
+    // the error is where the grammar first fails
+    EXPECT_PARSE_ERROR(ParseResult::MissComma, "[[1 [[]]]]");
+    EXPECT_TRUE(reader.parseIndexed("[[1],{}]", value));
+    EXPECT_FALSE(reader.parseIndexed("[[[1]]]", value));
+    EXPECT_EQ(ParseResult::DepthExceeded, reader.result());
+    EXPECT_FALSE(reader.parseParallel("[[1],[[2]]]", value, 2));
+    EXPECT_EQ(ParseResult::DepthExceeded, reader.result());
+
+    // no stack is taken for the depth, only for a tree as deep
+    const auto deep = nest(100'000);
+    reader.setMaxDepth(100'000);
+    BaseHandler handler;
+    EXPECT_TRUE(reader.parse(deep, handler));
+    ASSERT_TRUE(reader.parseIndexed(deep, value));
+    EXPECT_EQ(100'000U, releaseNested(value));
+    EXPECT_FALSE(reader.parseIndexed(nest(100'001), value));
+    EXPECT_EQ(ParseResult::DepthExceeded, reader.result());
+    reader.setMaxDepth(0);
+    EXPECT_TRUE(reader.parse("1", value));
+    EXPECT_PARSE_ERROR(ParseResult::DepthExceeded, "[]");
+}
+
+TEST_F(ReaderTest, ParseIndexedDeep) {
+    // no stack is taken for the depth, nor for a failed value discarded
+    const std::string open(200'000, '[');
+    reader.setMaxDepth(open.size() + 1);
+    Value value;
+    EXPECT_FALSE(reader.parseIndexed(open, value));
+    EXPECT_EQ(ParseResult::MissSquareBracket, reader.result());
+    EXPECT_TRUE(value.isNull());
+    EXPECT_FALSE(reader.parse(open, value));
+    EXPECT_EQ(ParseResult::MissSquareBracket, reader.result());
+}
+
+namespace {
+
+// records events as text, one per line
+struct RecordingHandler {
+    void onNull() { events += "null\n"; }
+    void onBool(const Bool val) { events += val ? "true\n" : "false\n"; }
+    void onInteger(const Integer val) {
+        events += "integer " + std::to_string(val) + "\n";
+    }
+    void onUInteger(const UInteger val) {
+        events += "uinteger " + std::to_string(val) + "\n";
+    }
+    void onReal(const Real val) {
+        events += "real " + std::to_string(val) + "\n";
+    }
+    void onString(const std::string_view str) {
+        events += "string " + std::string(str) + "\n";
+    }
+    void onStartArray() { events += "[\n"; }
+    void onEndArray(const size_t size) {
+        events += "] " + std::to_string(size) + "\n";
+    }
+    void onStartObject() { events += "{\n"; }
+    void onKey(const std::string_view key) {
+        events += "key " + std::string(key) + "\n";
+    }
+    void onEndObject(const size_t size) {
+        events += "} " + std::to_string(size) + "\n";
+    }
+
+    std::string events;
+};
+
+}  // namespace
+
+TEST_F(ReaderTest, ParseEvents) {
+    RecordingHandler handler;
+    EXPECT_TRUE(reader.parse(
+        R"({"a":[null,true,false,-1,18446744073709551615,0.5],"b\n":{},)"
+        R"("c":"x\ty"})",
+        handler));
+    EXPECT_EQ(
+        "{\n"
+        "key a\n"
+        "[\n"
+        "null\n"
+        "true\n"
+        "false\n"
+        "integer -1\n"
+        "uinteger 18446744073709551615\n"
+        "real 0.500000\n"
+        "] 6\n"
+        "key b\n\n"
+        "{\n"
+        "} 0\n"
+        "key c\n"
+        "string x\ty\n"
+        "} 3\n",
+        handler.events);
+
+    // the same overloads as for values
+    handler.events.clear();
+    EXPECT_TRUE(reader.parse(std::string(" [] "), handler));
+    EXPECT_TRUE(reader.parse("1 ", 1, handler));
+    EXPECT_EQ("[\n] 0\ninteger 1\n", handler.events);
+}
+
+TEST_F(ReaderTest, ParseEventsError) {
+    // events up to the error are delivered, then parsing stops
+    RecordingHandler handler;
+    EXPECT_FALSE(reader.parse(R"([1,{"a":tru},2])", handler));
+    EXPECT_EQ(ParseResult::InvalidValue, reader.result());
+    EXPECT_EQ("[\ninteger 1\n{\nkey a\n", handler.events);
+
+    handler.events.clear();
+    EXPECT_FALSE(reader.parse(static_cast<const char*>(nullptr), handler));
+    EXPECT_EQ(ParseResult::ExpectValue, reader.result());
+    EXPECT_EQ("", handler.events);
+}
+
+TEST_F(ReaderTest, ParseEventsStringViews) {
+    // strings without escapes are views into the document
+    struct Handler : BaseHandler {
+        void onString(const std::string_view str) { strings.push_back(str); }
+        std::vector<std::string_view> strings;
+    } handler;
+    const std::string doc = R"(["abc","de"])";
+    EXPECT_TRUE(reader.parse(doc, handler));
+    ASSERT_EQ(2, handler.strings.size());
+    EXPECT_EQ(doc.data() + 2, handler.strings[0].data());
+    EXPECT_EQ(doc.data() + 8, handler.strings[1].data());
+    EXPECT_EQ("de", handler.strings[1]);
+}
+
 }  // namespace SimpleJson
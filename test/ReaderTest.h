@@ -31,6 +31,17 @@
         }                                            \
     } while (false)
 
+#define EXPECT_PARSE_UINTEGER(expected, doc)          \
+    do {                                              \
+        Value value;                                  \
+        reader.parse(doc, value);                     \
+        EXPECT_EQ(ParseResult::Ok, reader.result());  \
+        EXPECT_EQ(ValueType::UInteger, value.type()); \
+        if (value.isUInteger()) {                     \
+            EXPECT_EQ(expected, value.asUInteger());  \
+        }                                             \
+    } while (false)
+
 #define EXPECT_PARSE_REAL(expected, doc)             \
     do {                                             \
         Value value;                                 \
@@ -0,0 +1,316 @@
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Simd.h"
+#include "gtest/gtest.h"
+
+namespace SimpleJson::Simd {
+
+namespace {
+
+constexpr std::string_view WHITESPACE = " \t\n\r";
+
+// every kernel must stop at the same char for all alignments and lengths
+void expectSkipWhitespace(const char* (*kernel)(const char*)) {
+    constexpr size_t MAX_OFFSET = 32;
+    constexpr size_t MAX_LENGTH = 100;
+    constexpr std::array<char, 5> STOPS = {'x', '\0', '\v', '{', '\x80'};
+
+    alignas(64) std::array<char, MAX_OFFSET + MAX_LENGTH + 64> buf{};
+    for (const char stop : STOPS) {
+        for (size_t offset = 0; offset < MAX_OFFSET; ++offset) {
+            for (size_t length = 0; length < MAX_LENGTH; ++length) {
+                buf.fill(' ');
+                const auto str = buf.data() + offset;
+                for (size_t i = 0; i < length; ++i) {
+                    str[i] = WHITESPACE[i % WHITESPACE.size()];
+                }
+                str[length] = stop;
+                str[length + 1] = '\0';
+
+                EXPECT_EQ(str + length, kernel(str))
+                    << "offset " << offset << ", length " << length;
+            }
+        }
+    }
+}
+
+// every kernel must stop at the same char for all alignments and lengths
+void expectScanString(const char* (*kernel)(const char*)) {
+    constexpr size_t MAX_OFFSET = 32;
+    constexpr size_t MAX_LENGTH = 100;
+    constexpr std::string_view UNESCAPED = "a !#[]~\x7F\x80\xFF";
+    constexpr std::array<char, 5> STOPS = {'"', '\\', '\0', '\x01', '\x1F'};
+
+    alignas(64) std::array<char, MAX_OFFSET + MAX_LENGTH + 64> buf{};
+    for (const char stop : STOPS) {
+        for (size_t offset = 0; offset < MAX_OFFSET; ++offset) {
+            for (size_t length = 0; length < MAX_LENGTH; ++length) {
+                // chars before `str` must not be taken into account
+                buf.fill('"');
+                const auto str = buf.data() + offset;
+                for (size_t i = 0; i < length; ++i) {
+                    str[i] = UNESCAPED[i % UNESCAPED.size()];
+                }
+                str[length] = stop;
+                str[length + 1] = '\0';
+
+                EXPECT_EQ(str + length, kernel(str))
+                    << "offset " << offset << ", length " << length;
+            }
+        }
+    }
+}
+
+// every kernel must stop at the same char for all alignments and lengths,
+// and at the end of the range before any special char past it
+void expectScanStringUntil(const char* (*kernel)(const char*, const char*)) {
+    constexpr size_t MAX_OFFSET = 32;
+    constexpr size_t MAX_LENGTH = 100;
+    constexpr std::string_view UNESCAPED = "a !#/[]~\x7F\x80\xFF";
+    constexpr std::array<char, 5> STOPS = {'"', '\\', '\0', '\x01', '\x1F'};
+
+    alignas(64) std::array<char, MAX_OFFSET + MAX_LENGTH + 64> buf{};
+    for (const char stop : STOPS) {
+        for (size_t offset = 0; offset < MAX_OFFSET; ++offset) {
+            for (size_t length = 0; length < MAX_LENGTH; ++length) {
+                // chars outside the range must not be taken into account
+                buf.fill(stop);
+                const auto str = buf.data() + offset;
+                for (size_t i = 0; i < length; ++i) {
+                    str[i] = UNESCAPED[i % UNESCAPED.size()];
+                }
+
+                EXPECT_EQ(str + length, kernel(str, str + length + 1))
+                    << "offset " << offset << ", length " << length;
+                EXPECT_EQ(str + length, kernel(str, str + length))
+                    << "offset " << offset << ", length " << length;
+            }
+        }
+    }
+}
+
+// every kernel must stop at the same char for all alignments and lengths,
+// and at the end of the range before any escaped char past it
+void expectFindEscape(const char* (*kernel)(const char*, const char*)) {
+    constexpr size_t MAX_OFFSET = 32;
+    constexpr size_t MAX_LENGTH = 100;
+    constexpr std::string_view PLAIN = "a !#[]~\x7F\x80\xFF";
+    constexpr std::array<char, 6> STOPS = {'"',  '\\',   '/',
+                                           '\0', '\x01', '\x1F'};
+
+    alignas(64) std::array<char, MAX_OFFSET + MAX_LENGTH + 64> buf{};
+    for (const char stop : STOPS) {
+        for (size_t offset = 0; offset < MAX_OFFSET; ++offset) {
+            for (size_t length = 0; length < MAX_LENGTH; ++length) {
+                // chars outside the range must not be taken into account
+                buf.fill(stop);
+                const auto str = buf.data() + offset;
+                for (size_t i = 0; i < length; ++i) {
+                    str[i] = PLAIN[i % PLAIN.size()];
+                }
+
+                EXPECT_EQ(str + length, kernel(str, str + length + 1))
+                    << "offset " << offset << ", length " << length;
+                EXPECT_EQ(str + length, kernel(str, str + length))
+                    << "offset " << offset << ", length " << length;
+            }
+        }
+    }
+}
+
+// the structural chars found a char at a time, see indexStructurals
+std::vector<uint32_t> scanStructurals(const std::string_view str,
+                                      bool& closed) {
+    std::vector<uint32_t> res;
+    bool inString = false;
+    bool escaped = false;
+    bool scalar = false;
+    for (size_t i = 0; i < str.size(); ++i) {
+        const char c = str[i];
+        // a backslash escapes the next char in strings and out of them
+        const bool quote = c == '"' && !escaped;
+        escaped = c == '\\' && !escaped;
+        if (inString) {
+            inString = !quote;
+            scalar = false;
+        } else if (quote) {
+            // a quotation mark right after a scalar opens a string too
+            if (!scalar) {
+                res.push_back(static_cast<uint32_t>(i));
+            }
+            inString = true;
+        } else if (c == '{' || c == '}' || c == '[' || c == ']' ||
+                   c == ':' || c == ',') {
+            res.push_back(static_cast<uint32_t>(i));
+            scalar = false;
+        } else if (isWhitespace(c)) {
+            scalar = false;
+        } else {
+            if (!scalar) {
+                res.push_back(static_cast<uint32_t>(i));
+            }
+            scalar = true;
+        }
+    }
+    closed = !inString;
+    return res;
+}
+
+// every kernel must find the same chars as a scan a char at a time, in
+// strings with runs of backslashes and quotation marks across blocks
+void expectIndexStructurals(bool (*kernel)(const char*, size_t, uint32_t*,
+                                           size_t&)) {
+    constexpr size_t DOCUMENTS = 3000;
+    constexpr size_t MAX_LENGTH = 300;
+    constexpr std::string_view CHARS = "{}[]:, \t\"\"\\\\\\a1-";
+
+    uint32_t seed = 1;
+    const auto random = [&seed] {
+        seed = seed * 1103515245U + 12345U;
+        return seed >> 16U;
+    };
+    for (size_t n = 0; n < DOCUMENTS; ++n) {
+        std::string str(random() % MAX_LENGTH, ' ');
+        for (auto& c : str) {
+            c = CHARS[random() % CHARS.size()];
+        }
+        bool expectedClosed = false;
+        const auto expected = scanStructurals(str, expectedClosed);
+
+        std::vector<uint32_t> positions(str.size());
+        size_t count = 0;
+        EXPECT_EQ(expectedClosed,
+                  kernel(str.data(), str.size(), positions.data(), count))
+            << str;
+        positions.resize(count);
+        EXPECT_EQ(expected, positions) << str;
+    }
+
+    const std::string_view json =
+        R"( {"a\"b" : [1, -2.5e3,true ,"\\"], "c":{}} )";
+    std::vector<uint32_t> positions(json.size());
+    size_t count = 0;
+    EXPECT_TRUE(kernel(json.data(), json.size(), positions.data(), count));
+    positions.resize(count);
+    EXPECT_EQ((std::vector<uint32_t>{1, 2, 9, 11, 12, 13, 15, 21, 22, 27, 28,
+                                     32, 33, 35, 38, 39, 40, 41}),
+              positions);
+}
+
+}  // namespace
+
+TEST(SimdTest, SkipWhitespaceScalar) {
+    expectSkipWhitespace(skipWhitespaceScalar);
+}
+
+TEST(SimdTest, SkipWhitespaceSse2) {
+    if (!hasSse2()) {
+        GTEST_SKIP();
+    }
+    expectSkipWhitespace(skipWhitespaceSse2);
+}
+
+TEST(SimdTest, SkipWhitespaceAvx2) {
+    if (!hasAvx2()) {
+        GTEST_SKIP();
+    }
+    expectSkipWhitespace(skipWhitespaceAvx2);
+}
+
+TEST(SimdTest, SkipWhitespaceDispatch) {
+    expectSkipWhitespace(skipWhitespace);
+}
+
+TEST(SimdTest, ScanStringSwar) {
+    expectScanString(scanStringSwar);
+}
+
+TEST(SimdTest, ScanStringSse2) {
+    if (!hasSse2()) {
+        GTEST_SKIP();
+    }
+    expectScanString(scanStringSse2);
+}
+
+TEST(SimdTest, ScanStringAvx2) {
+    if (!hasAvx2()) {
+        GTEST_SKIP();
+    }
+    expectScanString(scanStringAvx2);
+}
+
+TEST(SimdTest, ScanStringDispatch) {
+    expectScanString(scanString);
+}
+
+TEST(SimdTest, ScanStringUntilSwar) {
+    expectScanStringUntil(scanStringUntilSwar);
+}
+
+TEST(SimdTest, ScanStringUntilSse2) {
+    if (!hasSse2()) {
+        GTEST_SKIP();
+    }
+    expectScanStringUntil(scanStringUntilSse2);
+}
+
+TEST(SimdTest, ScanStringUntilAvx2) {
+    if (!hasAvx2()) {
+        GTEST_SKIP();
+    }
+    expectScanStringUntil(scanStringUntilAvx2);
+}
+
+TEST(SimdTest, ScanStringUntilDispatch) {
+    expectScanStringUntil(scanStringUntil);
+}
+
+TEST(SimdTest, FindEscapeSwar) {
+    expectFindEscape(findEscapeSwar);
+}
+
+TEST(SimdTest, FindEscapeSse2) {
+    if (!hasSse2()) {
+        GTEST_SKIP();
+    }
+    expectFindEscape(findEscapeSse2);
+}
+
+TEST(SimdTest, FindEscapeAvx2) {
+    if (!hasAvx2()) {
+        GTEST_SKIP();
+    }
+    expectFindEscape(findEscapeAvx2);
+}
+
+TEST(SimdTest, FindEscapeDispatch) {
+    expectFindEscape(findEscape);
+}
+
+TEST(SimdTest, IndexStructuralsScalar) {
+    expectIndexStructurals(indexStructuralsScalar);
+}
+
+TEST(SimdTest, IndexStructuralsSse2) {
+    if (!hasSse2()) {
+        GTEST_SKIP();
+    }
+    expectIndexStructurals(indexStructuralsSse2);
+}
+
+TEST(SimdTest, IndexStructuralsAvx2) {
+    if (!hasAvx2()) {
+        GTEST_SKIP();
+    }
+    expectIndexStructurals(indexStructuralsAvx2);
+}
+
+TEST(SimdTest, IndexStructuralsDispatch) {
+    expectIndexStructurals(indexStructurals);
+}
+
+}  // namespace SimpleJson::Simd
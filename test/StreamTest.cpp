@@ -0,0 +1,131 @@
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "TestHelper.h"
+#include "gtest/gtest.h"
+#include "simplejson/Reader.h"
+#include "simplejson/Stream.h"
+
+namespace SimpleJson {
+
+namespace {
+
+/// `count` lines of records, every `spanEvery`th one spanning lines
+std::string makeLines(const size_t count, const size_t spanEvery) {
+    std::string buffer;
+    for (size_t i = 0; i < count; ++i) {
+        const auto id = std::to_string(i);
+        if (spanEvery != 0 && i % spanEvery == 0) {
+            buffer += "{\n  \"id\": " + id + ",\n  \"tags\": [\n\"a\"\n]\n}\n";
+        } else {
+            buffer += R"({"id":)" + id + R"(,"name":"line \")" + id +
+                      R"(\"","ok":true})" + "\n";
+        }
+    }
+    return buffer;
+}
+
+/// the values of `buffer` read one at a time
+std::vector<Value> readAll(const std::string& buffer, ParseResult& result,
+                           size_t& offset) {
+    DocumentStream stream(buffer);
+    std::vector<Value> values;
+    for (Value value; stream.next(value);) {
+        values.push_back(std::move(value));
+    }
+    result = stream.result();
+    offset = stream.offset();
+    return values;
+}
+
+// the buffer is not copied, so a temporary one is refused
+static_assert(!std::is_constructible_v<DocumentStream, std::string>);
+static_assert(std::is_constructible_v<DocumentStream, const std::string&>);
+
+}  // namespace
+
+TEST(StreamTest, Next) {
+    DocumentStream stream(" 1 [2]{\"a\":3}\"b\"\n\ttrue null\r\n");
+    Value value;
+    ASSERT_TRUE(stream.next(value));
+    EXPECT_EQ(Value(1), value);
+    ASSERT_TRUE(stream.next(value));
+    EXPECT_EQ(2, value[0].asInteger());
+    ASSERT_TRUE(stream.next(value));
+    EXPECT_EQ(3, value["a"].asInteger());
+    ASSERT_TRUE(stream.next(value));
+    EXPECT_EQ("b", value.asString());
+    ASSERT_TRUE(stream.next(value));
+    EXPECT_TRUE(value.asBool());
+    ASSERT_TRUE(stream.next(value));
+    EXPECT_TRUE(value.isNull());
+    EXPECT_FALSE(stream.next(value));
+    EXPECT_TRUE(stream.good());
+    EXPECT_EQ(29U, stream.offset());
+
+    DocumentStream empty(" \n ");
+    EXPECT_FALSE(empty.next(value));
+    EXPECT_TRUE(empty.good());
+}
+
+TEST(StreamTest, Errors) {
+    const auto expectError = [](const ParseResult expected,
+                                const size_t offset, const char* buffer) {
+        DocumentStream stream(buffer);
+        Value value;
+        while (stream.next(value)) {
+        }
+        EXPECT_EQ(expected, stream.result()) << buffer;
+        EXPECT_EQ(offset, stream.offset()) << buffer;
+        EXPECT_TRUE(value.isNull()) << buffer;
+        // stays failed
+        EXPECT_FALSE(stream.next(value)) << buffer;
+    };
+    expectError(ParseResult::InvalidValue, 6, "1\n2\n3\n?\n4");
+    expectError(ParseResult::MissComma, 3, "{}\n[1 2]");
+    expectError(ParseResult::MissQuotationMark, 2, "1 \"a");
+    expectError(ParseResult::InvalidValue, 2, "[]]");
+}
+
+TEST(StreamTest, ParseAll) {
+    for (const size_t spanEvery : {0, 1, 7}) {
+        const auto buffer = makeLines(500, spanEvery);
+        ParseResult result = ParseResult::Ok;
+        size_t offset = 0;
+        const auto expected = readAll(buffer, result, offset);
+        ASSERT_EQ(500U, expected.size());
+        for (const unsigned threads : {1U, 2U, 4U}) {
+            for (const size_t batchSize : {1, 100, 4096}) {
+                DocumentStream stream(buffer);
+                std::vector<Value> values;
+                EXPECT_TRUE(stream.parseAll(values, threads, batchSize));
+                EXPECT_EQ(expected, values) << threads << " " << batchSize;
+                EXPECT_EQ(offset, stream.offset());
+            }
+        }
+    }
+}
+
+TEST(StreamTest, ParseAllErrors) {
+    const auto buffer = makeLines(300, 5);
+    // errors of a sequential read, past batches parsed in full
+    for (const auto& error : {"[1,\n2", "{\"a\"\n:}", "\"x\ny\"", "]"}) {
+        auto broken = buffer;
+        broken.insert(broken.find("{\"id\":201"), std::string(error) + "\n");
+        ParseResult result = ParseResult::Ok;
+        size_t offset = 0;
+        const auto expected = readAll(broken, result, offset);
+        ASSERT_NE(ParseResult::Ok, result);
+        for (const unsigned threads : {1U, 3U}) {
+            DocumentStream stream(broken);
+            std::vector<Value> values;
+            EXPECT_FALSE(stream.parseAll(values, threads, 64));
+            EXPECT_EQ(result, stream.result()) << error;
+            EXPECT_EQ(offset, stream.offset()) << error;
+            EXPECT_EQ(expected, values) << error;
+        }
+    }
+}
+
+}  // namespace SimpleJson
@@ -0,0 +1,153 @@
+#include <stdexcept>
+#include <string>
+#include <variant>
+
+#include "TestHelper.h"
+#include "gtest/gtest.h"
+#include "simplejson/Reader.h"
+#include "simplejson/Tape.h"
+
+namespace SimpleJson {
+
+namespace {
+
+const std::string DOCUMENT = R"( {
+    "name": "tape",
+    "escaped": "tab\t\u0000nul",
+    "numbers": [0, -1, 18446744073709551615, 0.5, 1e2],
+    "flags": [true, false, null],
+    "nested": {"list": [[], {}, {"deep": "value"}]},
+    "repeated": 1,
+    "repeated": 2
+} )";
+
+}  // namespace
+
+TEST(TapeTest, Navigate) {
+    TapeDocument doc;
+    ASSERT_TRUE(doc.parse(DOCUMENT));
+    EXPECT_EQ(ParseResult::Ok, doc.result());
+    EXPECT_TRUE(doc.root().isObject());
+    EXPECT_EQ(7, doc.root().size());
+    EXPECT_EQ("tape", doc["name"].asStringView());
+    EXPECT_EQ(std::string("tab\t\0nul", 8), doc["escaped"].asString());
+    EXPECT_STREQ("tab\t", doc["escaped"].asCString());
+    EXPECT_EQ("value", doc["nested"]["list"][2]["deep"].asString());
+    EXPECT_TRUE(doc["nested"]["list"][0].isArray());
+    EXPECT_TRUE(doc["nested"]["list"][0].empty());
+    EXPECT_TRUE(doc["nested"]["list"][1].isObject());
+    EXPECT_TRUE(doc["nested"].isMember("list"));
+    EXPECT_FALSE(doc["nested"].isMember("lis"));
+    EXPECT_EQ("flags", doc.root().getMemberName(3));
+    EXPECT_EQ(3, doc.root().getMemberValue(3).size());
+    // the last of repeated keys, as parse keeps
+    EXPECT_EQ(2, doc["repeated"].asInteger());
+}
+
+TEST(TapeTest, ReadScalars) {
+    TapeDocument doc;
+    ASSERT_TRUE(doc.parse(DOCUMENT));
+    const auto numbers = doc["numbers"];
+    EXPECT_EQ(5, numbers.size());
+    EXPECT_EQ(0, numbers[0].asInteger());
+    EXPECT_EQ(-1, numbers[1].asInteger());
+    EXPECT_TRUE(numbers[2].isUInteger());
+    EXPECT_EQ(18446744073709551615ULL, numbers[2].asUInteger());
+    EXPECT_TRUE(numbers[3].isReal());
+    EXPECT_EQ(0.5, numbers[3].asReal());
+    EXPECT_EQ(100.0, numbers[4].asReal());
+    EXPECT_TRUE(doc["flags"][0].asBool());
+    EXPECT_FALSE(doc["flags"][1].asBool());
+    EXPECT_TRUE(doc["flags"][2].isNull());
+    EXPECT_TRUE(doc["flags"][2].empty());
+    EXPECT_FALSE(doc["flags"][0].empty());
+    EXPECT_EQ(0, doc["name"].size());
+}
+
+TEST(TapeTest, Iterate) {
+    TapeDocument doc;
+    ASSERT_TRUE(doc.parse(DOCUMENT));
+    std::string keys;
+    for (auto it = doc.root().begin(); it != doc.root().end(); ++it) {
+        keys += std::string(it.key()) + ":" +
+                std::to_string(static_cast<int>((*it).type())) + " ";
+    }
+    EXPECT_EQ(
+        "name:5 escaped:5 numbers:6 flags:6 nested:7 repeated:2 repeated:2 ",
+        keys);
+
+    size_t count = 0;
+    for (const auto element : doc["nested"]["list"]) {
+        EXPECT_TRUE(element.isArray() || element.isObject());
+        ++count;
+    }
+    EXPECT_EQ(3, count);
+    EXPECT_TRUE(doc["name"].begin() == doc["name"].end());
+    EXPECT_TRUE(doc["nested"]["list"][0].begin() ==
+                doc["nested"]["list"][0].end());
+}
+
+TEST(TapeTest, AccessErrors) {
+    TapeDocument doc;
+    ASSERT_TRUE(doc.parse(DOCUMENT));
+    EXPECT_THROW((void)doc["name"].asInteger(), std::bad_variant_access);
+    EXPECT_THROW((void)doc["numbers"][0].asUInteger(),
+                 std::bad_variant_access);
+    EXPECT_THROW((void)doc["numbers"]["x"], std::bad_variant_access);
+    EXPECT_THROW((void)doc["name"][0], std::bad_variant_access);
+    EXPECT_THROW((void)doc["none"], std::out_of_range);
+    EXPECT_THROW((void)doc["numbers"][5], std::out_of_range);
+    EXPECT_THROW((void)doc["nested"]["list"][1].getMemberName(0),
+                 std::out_of_range);
+}
+
+TEST(TapeTest, ToValue) {
+    TapeDocument doc;
+    ASSERT_TRUE(doc.parse(DOCUMENT));
+    Reader reader;
+    Value expected;
+    ASSERT_TRUE(reader.parse(DOCUMENT, expected));
+    EXPECT_EQ(expected, doc.root().toValue());
+    EXPECT_EQ(expected["nested"], doc["nested"].toValue());
+
+    // a copy to modify
+    auto value = doc["numbers"].toValue();
+    value.append(Value("six"));
+    EXPECT_EQ(6, value.size());
+    EXPECT_EQ(5, doc["numbers"].size());
+}
+
+TEST(TapeTest, RepeatedKey) {
+    const std::string json = R"({"a":1,"b":{"c":0,"c":[3]},"a":2})";
+    TapeDocument doc;
+    ASSERT_TRUE(doc.parse(json));
+    Reader reader;
+    Value expected;
+    ASSERT_TRUE(reader.parse(json, expected));
+    // the last value at the place of the first, as parse keeps
+    EXPECT_EQ(expected, doc.root().toValue());
+    EXPECT_EQ("a", doc.root().toValue().getMemberName(0));
+    EXPECT_EQ(2, doc["a"].asInteger());
+    EXPECT_EQ(3, doc["b"]["c"][0].asInteger());
+    // all of them are still iterated
+    EXPECT_EQ(3, doc.root().size());
+    EXPECT_EQ(1, doc.root().getMemberValue(0).asInteger());
+}
+
+TEST(TapeTest, ParseErrors) {
+    TapeDocument doc;
+    EXPECT_TRUE(doc.root().isNull());
+    EXPECT_FALSE(doc.parse(R"({"a":[1,2)"));
+    EXPECT_EQ(ParseResult::MissSquareBracket, doc.result());
+    EXPECT_TRUE(doc.root().isNull());
+    EXPECT_FALSE(doc.parse(nullptr));
+    EXPECT_EQ(ParseResult::ExpectValue, doc.result());
+
+    // parsing again replaces the document
+    ASSERT_TRUE(doc.parse("[\"a\", 1]"));
+    ASSERT_TRUE(doc.parse("\"b\""));
+    EXPECT_TRUE(doc.good());
+    EXPECT_EQ("b", doc.root().asStringView());
+}
+
+}  // namespace SimpleJson
@@ -10,6 +10,8 @@ std::ostream& operator<<(std::ostream& out, SimpleJson::ValueType val) {
             return out << "[Bool]";
         case SimpleJson::ValueType::Integer:
             return out << "[Integer]";
+        case SimpleJson::ValueType::UInteger:
+            return out << "[UInteger]";
         case SimpleJson::ValueType::Real:
             return out << "[Real]";
         case SimpleJson::ValueType::String:
@@ -56,6 +58,10 @@ std::ostream& operator<<(std::ostream& out, SimpleJson::ParseResult val) {
             return out << "[MissColon]";
         case SimpleJson::ParseResult::MissCurlyBracket:
             return out << "[MissCurlyBracket]";
+        case SimpleJson::ParseResult::InvalidFile:
+            return out << "[InvalidFile]";
+        case SimpleJson::ParseResult::DepthExceeded:
+            return out << "[DepthExceeded]";
     }
 
     // not possible
@@ -2,7 +2,10 @@
 
 #include <cfloat>
 #include <climits>
+#include <cstdint>
+#include <memory_resource>
 #include <string>
+#include <vector>
 
 #include "TestHelper.h"
 #include "gtest/gtest.h"
@@ -79,8 +82,6 @@ TEST(ValueTest, TypeIntegerSigned) {
     EXPECT_VALUE_INTEGER(LLONG_MIN);
 }
 
-// TODO: uint support
-#if 0
 TEST(ValueTest, TypeIntegerUnsigned) {
     // unsigned int
     EXPECT_VALUE_INTEGER(0U);
@@ -90,14 +91,18 @@ TEST(ValueTest, TypeIntegerUnsigned) {
     // unsigned long
     EXPECT_VALUE_INTEGER(0UL);
     EXPECT_VALUE_INTEGER(1UL);
-    EXPECT_VALUE_INTEGER(ULONG_MAX);
 
-    // unsigned long long
+    // unsigned long long, an UInteger only above the range of Integer
     EXPECT_VALUE_INTEGER(0ULL);
     EXPECT_VALUE_INTEGER(1ULL);
-    EXPECT_VALUE_INTEGER(ULLONG_MAX);
+    EXPECT_VALUE_INTEGER(static_cast<unsigned long long>(LLONG_MAX));
+    EXPECT_VALUE_UINTEGER(static_cast<unsigned long long>(LLONG_MAX) + 1);
+    EXPECT_VALUE_UINTEGER(ULLONG_MAX);
+    EXPECT_VALUE_UINTEGER(UINT64_MAX);
+
+    EXPECT_EQ(Value(1), Value(1ULL));
+    EXPECT_NE(Value(-1), Value(ULLONG_MAX));
 }
-#endif
 
 TEST(ValueTest, TypeReal) {
     Value val(ValueType::Real);
@@ -168,6 +173,72 @@ TEST(ValueTest, TypeString) {
     EXPECT_EQ(val, other);
 }
 
+TEST(ValueTest, TypeStringView) {
+    const std::string str = "hello";
+    auto val = Value::view(str);
+    ASSERT_EQ(ValueType::String, val.type());
+    EXPECT_EQ(str, val.asString());
+    EXPECT_EQ(str.data(), val.asCString());
+
+    // copies refer to the same chars
+    const auto other = val;
+    EXPECT_EQ(val, other);
+    EXPECT_EQ(str.data(), other.asCString());
+
+    val = Value::view("");
+    EXPECT_TRUE(val.asStringView().empty());
+    EXPECT_EQ(Value(""), val);
+}
+
+TEST(ValueTest, TypeStringInline) {
+    // no larger than a pointer and a size besides the type
+    EXPECT_LE(sizeof(Value), 3 * sizeof(void*));
+
+    // short strings never touch the resource
+    const std::string shortest(15, 's');
+    const Value inlined(std::string_view(shortest),
+                        std::pmr::null_memory_resource());
+    EXPECT_EQ(shortest, inlined.asString());
+    const std::string longer = shortest + "s";
+    EXPECT_THROW(Value(std::string_view(longer),
+                       std::pmr::null_memory_resource()),
+                 std::bad_alloc);
+
+    const auto expectString = [](const std::string& expect, const Value& val) {
+        ASSERT_EQ(ValueType::String, val.type());
+        EXPECT_EQ(expect, val.asString());
+        if (!expect.empty()) {
+            EXPECT_EQ(0, val.asCString()[expect.size()]);
+        }
+    };
+    // around the inline capacity
+    for (const size_t lhsSize : {0, 1, 14, 15, 16, 17, 64}) {
+        for (const size_t rhsSize : {0, 1, 14, 15, 16, 17, 64}) {
+            const std::string lhs(lhsSize, 'l');
+            const std::string rhs(rhsSize, 'r');
+
+            Value copy(lhs);
+            copy = Value(rhs);
+            expectString(rhs, copy);
+            const auto other = copy;
+            expectString(rhs, other);
+
+            Value moved(lhs);
+            Value source(rhs);
+            moved = std::move(source);
+            expectString(rhs, moved);
+            const Value constructed(std::move(moved));
+            expectString(rhs, constructed);
+
+            Value first(lhs);
+            Value second(rhs);
+            first.swap(second);
+            expectString(rhs, first);
+            expectString(lhs, second);
+        }
+    }
+}
+
 TEST(ValueTest, TypeArray) {
     Value val(ValueType::Array);
     EXPECT_TRUE(val.isArray());
@@ -256,4 +327,93 @@ TEST(ValueTest, TypeObject) {
     EXPECT_NE(val, other);
 }
 
+TEST(ValueTest, ObjectOrder) {
+    Value val(ValueType::Object);
+    val["b"] = 1;
+    val["a"] = 2;
+    val["c"] = 3;
+    val["a"] = 4;
+
+    // members keep their insertion order
+    const std::vector<std::string> keys = {"b", "a", "c"};
+    EXPECT_EQ(keys, val.getMemberNames());
+    ASSERT_EQ(3, val.size());
+    EXPECT_EQ("a", val.getMemberName(1));
+    EXPECT_EQ(4, val.getMemberValue(1).asInteger());
+
+    EXPECT_EQ(1, val.removeMember("b").asInteger());
+    EXPECT_EQ("a", val.getMemberName(0));
+    EXPECT_EQ("c", val.getMemberName(1));
+
+    // but are compared regardless of it
+    Value other(ValueType::Object);
+    other["c"] = 3;
+    other["a"] = 4;
+    EXPECT_EQ(val, other);
+    other["a"] = 5;
+    EXPECT_NE(val, other);
+}
+
+TEST(ValueTest, ObjectLarge) {
+    // past the linear scan, members are found by hash
+    constexpr auto COUNT = 1000;
+    Value val(ValueType::Object);
+    for (int i = 0; i < COUNT; ++i) {
+        val["key" + std::to_string(i)] = i;
+    }
+    ASSERT_EQ(COUNT, val.size());
+    for (int i = 0; i < COUNT; ++i) {
+        const auto key = "key" + std::to_string(i);
+        EXPECT_EQ(key, val.getMemberName(i));
+        EXPECT_EQ(i, val[key].asInteger());
+    }
+    EXPECT_FALSE(val.isMember("key1000"));
+
+    // removals shift later members down
+    for (int i = 0; i < COUNT; i += 2) {
+        EXPECT_EQ(i, val.removeMember("key" + std::to_string(i)).asInteger());
+    }
+    ASSERT_EQ(COUNT / 2, val.size());
+    for (int i = 1; i < COUNT; i += 2) {
+        EXPECT_EQ("key" + std::to_string(i), val.getMemberName(i / 2));
+        EXPECT_EQ(i, val["key" + std::to_string(i)].asInteger());
+        EXPECT_FALSE(val.isMember("key" + std::to_string(i - 1)));
+    }
+
+    const auto other = val;
+    EXPECT_EQ(val, other);
+    while (!val.empty()) {
+        EXPECT_TRUE(val.removeMember(val.getMemberNames().back()).isInteger());
+    }
+    EXPECT_NE(val, other);
+}
+
+TEST(ValueTest, CopyToResource) {
+    Value val(ValueType::Object);
+    val["string"] = "a string long enough to need an allocation";
+    val["array"] = Value(ValueType::Array);
+    val["array"].append(val);
+    val["array"].append(1);
+
+    // nothing may come from the default resource
+    std::pmr::monotonic_buffer_resource arena;
+    auto* const previous =
+        std::pmr::set_default_resource(std::pmr::null_memory_resource());
+    auto* const copy = new Value(val, &arena);
+    (*copy)["array"][1] = 2;
+    (*copy)["new"] = Value(ValueType::Array, &arena);
+    std::pmr::set_default_resource(previous);
+
+    EXPECT_EQ(2, (*copy)["array"][1].asInteger());
+    (*copy)["array"][1] = 1;
+    EXPECT_TRUE(copy->removeMember("new").isArray());
+    EXPECT_EQ(val, *copy);
+
+    // a plain copy is allocated from the default resource
+    const auto other = *copy;
+    delete copy;
+    arena.release();
+    EXPECT_EQ(val, other);
+}
+
 }  // namespace SimpleJson
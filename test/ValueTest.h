@@ -10,6 +10,15 @@
         }                                            \
     } while (false)
 
+#define EXPECT_VALUE_UINTEGER(number)                 \
+    do {                                              \
+        auto value = Value(number);                   \
+        EXPECT_EQ(ValueType::UInteger, value.type()); \
+        if (value.isUInteger()) {                     \
+            EXPECT_EQ(number, value.asUInteger());    \
+        }                                             \
+    } while (false)
+
 #define EXPECT_VALUE_REAL(number)                 \
     do {                                          \
         auto value = Value(number);               \
@@ -1,5 +1,15 @@
 #include "WriterTest.h"
 
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
 #include "TestHelper.h"
 #include "gtest/gtest.h"
 #include "simplejson/Reader.h"
@@ -27,6 +37,21 @@ TEST_F(WriterTest, RoundtripInteger) {
     ROUNDTRIP_TEST("-2147483648");
     ROUNDTRIP_TEST("9223372036854775807");
     ROUNDTRIP_TEST("-9223372036854775808");
+    ROUNDTRIP_TEST("9223372036854775808");
+    ROUNDTRIP_TEST("18446744073709551615");
+}
+
+TEST_F(WriterTest, RoundtripIntegerDigits) {
+    // every width of digits, around each power of ten
+    for (uint64_t power = 1; power <= UINT64_MAX / 10; power *= 10) {
+        for (const auto number : {power - 1, power, power * 10 - 1}) {
+            const auto digits = std::to_string(number);
+            ROUNDTRIP_TEST(digits);
+            if (number <= uint64_t(INT64_MAX)) {
+                ROUNDTRIP_TEST("-" + digits);
+            }
+        }
+    }
 }
 
 TEST_F(WriterTest, RoundtripRealNumber) {
@@ -57,6 +82,43 @@ TEST_F(WriterTest, RoundtripRealNumber) {
     ROUNDTRIP_TEST("-1.7976931348623157e+308");
 }
 
+TEST_F(WriterTest, WriteRealShortest) {
+    EXPECT_EQ("0.1", writer.write(0.1));
+    EXPECT_EQ("-1.5", writer.write(-1.5));
+    EXPECT_EQ("1e+20", writer.write(1e20));
+    EXPECT_EQ("5e-324", writer.write(5e-324));
+    EXPECT_EQ("1.7976931348623157e+308", writer.write(DBL_MAX));
+    EXPECT_EQ("0.30000000000000004", writer.write(0.1 + 0.2));
+
+    // integral reals stay reals when read back
+    EXPECT_EQ("100.0", writer.write(100.0));
+    EXPECT_EQ("-0.0", writer.write(-0.0));
+    ROUNDTRIP_TEST("100.0");
+    Value value;
+    ASSERT_TRUE(reader.parse(writer.write(3.0), value));
+    EXPECT_EQ(ValueType::Real, value.type());
+}
+
+TEST_F(WriterTest, RoundtripRealRandom) {
+    // random doubles of all magnitudes are written and read back exactly
+    std::mt19937_64 random(42);
+    for (int i = 0; i < 10'000; ++i) {
+        const uint64_t bits = random();
+        double number = 0;
+        std::memcpy(&number, &bits, sizeof(number));
+        if (!std::isfinite(number)) {
+            continue;
+        }
+
+        Value value;
+        const auto doc = writer.write(number);
+        ASSERT_TRUE(reader.parse(doc, value)) << doc;
+        ASSERT_EQ(ValueType::Real, value.type()) << doc;
+        EXPECT_EQ(number, value.asReal()) << doc;
+        EXPECT_LE(doc.size(), 24) << doc;
+    }
+}
+
 TEST_F(WriterTest, RoundtripString) {
     ROUNDTRIP_TEST(R"("")");
     ROUNDTRIP_TEST(R"("Hello")");
@@ -65,6 +127,34 @@ TEST_F(WriterTest, RoundtripString) {
     ROUNDTRIP_TEST(R"("Hello\u0000World")");
 }
 
+TEST_F(WriterTest, WriteStringEscapes) {
+    EXPECT_EQ(R"("\" \\ \/ \b \f \n \r \t \u0001 \u001F")",
+              writer.write("\" \\ / \b \f \n \r \t \x01 \x1F"));
+
+    // each char at every position of a string longer than a block
+    for (int c = 0; c < 256; ++c) {
+        std::string expectedChar(1, static_cast<char>(c));
+        if (c == '"' || c == '\\' || c == '/') {
+            expectedChar.insert(0, 1, '\\');
+        } else if (c < 0x20) {
+            const auto escapes = std::string_view("btnvfr");
+            std::array<char, 8> buf{};
+            std::snprintf(buf.data(), buf.size(), "\\u%04X", c);
+            expectedChar = c >= '\b' && c <= '\r' && c != '\v'
+                               ? std::string{'\\', escapes[c - '\b']}
+                               : std::string(buf.data());
+        }
+        for (size_t pos = 0; pos < 40; ++pos) {
+            auto str = std::string(40, 'a');
+            str[pos] = static_cast<char>(c);
+            auto expected = "\"" + std::string(40, 'a') + "\"";
+            expected.replace(pos + 1, 1, expectedChar);
+            EXPECT_EQ(expected, writer.write(Value(std::string_view(str))))
+                << "char " << c << ", position " << pos;
+        }
+    }
+}
+
 TEST_F(WriterTest, RoundtripArray) {
     ROUNDTRIP_TEST("[]");
     ROUNDTRIP_TEST("[null,false,true,123,1.5,\"abc\",[1,2,3]]");
@@ -86,4 +176,155 @@ TEST_F(WriterTest, RoundtripObject) {
     ROUNDTRIP_TEST(doc);
 }
 
+TEST_F(WriterTest, WriteObjectOrder) {
+    // members are written in insertion order
+    Value value(ValueType::Object);
+    value["b"] = 1;
+    value["a"] = Value(ValueType::Object);
+    value["a"]["z"] = true;
+    value["a"]["y"] = false;
+    value["c"] = 3;
+    EXPECT_EQ(R"({"b":1,"a":{"z":true,"y":false},"c":3})", writer.write(value));
+
+    // so a parsed document keeps its order
+    const auto doc = R"({"z":null,"y":[],"x":{}})";
+    reader.parse(doc, value);
+    ASSERT_EQ(ParseResult::Ok, reader.result());
+    EXPECT_EQ(doc, writer.write(value));
+}
+
+namespace {
+
+// an array of records, a few chunks long when written
+Value makeLargeArray() {
+    Value value(ValueType::Array);
+    for (int i = 0; i < 10'000; ++i) {
+        Value record(ValueType::Object);
+        record["id"] = i;
+        record["name"] = "record " + std::to_string(i);
+        record["score"] = i * 0.25;
+        value.append(std::move(record));
+    }
+    return value;
+}
+
+}  // namespace
+
+TEST_F(WriterTest, WriteAppend) {
+    std::string doc = "prefix ";
+    writer.write(Value(ValueType::Array), doc);
+    writer.write(Value(true), doc);
+    EXPECT_EQ("prefix []true", doc);
+
+    // a cleared document is written into without allocation
+    const auto value = makeLargeArray();
+    doc.clear();
+    writer.write(value, doc);
+    const auto expected = doc;
+    const auto capacity = doc.capacity();
+    const auto* const data = doc.data();
+    doc.clear();
+    writer.write(value, doc);
+    EXPECT_EQ(expected, doc);
+    EXPECT_EQ(capacity, doc.capacity());
+    EXPECT_EQ(data, doc.data());
+}
+
+TEST_F(WriterTest, WriteSink) {
+    const auto value = makeLargeArray();
+    const auto expected = writer.write(value);
+    ASSERT_GT(expected.size(), 2 * Writer::CHUNK_SIZE);
+
+    // chunks of bounded size make up the same document
+    std::string doc;
+    size_t chunks = 0;
+    writer.write(value, [&](const std::string_view chunk) {
+        EXPECT_FALSE(chunk.empty());
+        EXPECT_LT(chunk.size(), Writer::CHUNK_SIZE + 100);
+        doc += chunk;
+        ++chunks;
+    });
+    EXPECT_EQ(expected, doc);
+    EXPECT_GT(chunks, 2);
+
+    // a small document is a single chunk
+    chunks = 0;
+    writer.write(Value("abc"), [&](const std::string_view chunk) {
+        EXPECT_EQ("\"abc\"", chunk);
+        ++chunks;
+    });
+    EXPECT_EQ(1, chunks);
+
+    // a throwing sink leaves the writer usable
+    EXPECT_THROW(writer.write(value,
+                              [](std::string_view) {
+                                  throw std::runtime_error("full");
+                              }),
+                 std::runtime_error);
+    EXPECT_EQ(expected, writer.write(value));
+}
+
+TEST_F(WriterTest, WriteParallel) {
+    // large containers at the root and within, and small ones
+    Value value(ValueType::Object);
+    value["records"] = makeLargeArray();
+    for (int i = 0; i < 100; ++i) {
+        value["key " + std::to_string(i)] = Value(ValueType::Array);
+    }
+    value["records"][7]["tags"] = Value(ValueType::Array);
+    value["records"][7]["tags"].append("x");
+    const auto expected = writer.write(value);
+
+    // byte-identical, on one thread or several, whatever the threshold
+    for (const unsigned threads : {1U, 2U, 3U, 8U}) {
+        for (const size_t threshold : {size_t(1), size_t(50), size_t(5000),
+                                       Writer::PARALLEL_THRESHOLD}) {
+            Writer parallel(threads, threshold);
+            EXPECT_EQ(expected, parallel.write(value))
+                << threads << " " << threshold;
+
+            std::string doc;
+            parallel.write(value, [&](const std::string_view chunk) {
+                EXPECT_FALSE(chunk.empty());
+                EXPECT_LT(chunk.size(), Writer::CHUNK_SIZE + 100);
+                doc += chunk;
+            });
+            EXPECT_EQ(expected, doc) << threads << " " << threshold;
+        }
+    }
+
+    Writer parallel(4, 1);
+    EXPECT_EQ("[]", parallel.write(Value(ValueType::Array)));
+    EXPECT_EQ("{}", parallel.write(Value(ValueType::Object)));
+    Value nested;
+    reader.parse(R"([[1],{"a":[2,{}]},3])", nested);
+    EXPECT_EQ(R"([[1],{"a":[2,{}]},3])", parallel.write(nested));
+}
+
+TEST_F(WriterTest, WriteStream) {
+    const auto value = makeLargeArray();
+    const auto expected = writer.write(value);
+
+    std::ostringstream os;
+    EXPECT_TRUE(writer.write(value, os));
+    EXPECT_EQ(expected, os.str());
+
+    os.setstate(std::ios::badbit);
+    EXPECT_FALSE(writer.write(value, os));
+}
+
+TEST_F(WriterTest, WriteFile) {
+    const auto value = makeLargeArray();
+    const auto expected = writer.write(value);
+
+    auto* const file = std::tmpfile();
+    ASSERT_NE(nullptr, file);
+    EXPECT_TRUE(writer.write(value, file));
+    std::string doc(expected.size() + 1, '\0');
+    std::rewind(file);
+    doc.resize(std::fread(doc.data(), 1, doc.size(), file));
+    std::fclose(file);
+    EXPECT_EQ(expected, doc);
+}
+
 }  // namespace SimpleJson